@@ -0,0 +1,366 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Чтение пакета файлов и разбор на рабочих потоках (Batch.h)
+constexpr auto batchDeclaration = R"(// Чтение группы файлов одним пакетом запросов: io_uring на Linux, иначе - обычное чтение
+class FileReader {
+public:
+    struct File {
+        std::string content;
+        std::string error; // Пусто - файл прочитан
+    };
+
+    explicit FileReader(unsigned depth = 32);
+    ~FileReader();
+    FileReader(const FileReader&) = delete;
+    FileReader& operator=(const FileReader&) = delete;
+
+    // Читает paths в files (по индексам paths)
+    void read(std::span<const std::string> paths, std::vector<File>& files);
+    // false - io_uring недоступен (не Linux, ядро или песочница), файлы читаются по одному
+    bool usesIoUring() const { return ring_ != nullptr; }
+
+private:
+    struct Ring;
+    std::unique_ptr<Ring> ring_;
+};
+
+// Файл пакета: загруженное значение или текст ошибки
+template <class T>
+struct BatchItem {
+    std::optional<Record<T>> value;
+    std::string error;
+};
+
+struct BatchOptions {
+    unsigned threads = 0;          // 0 - по числу ядер
+    std::size_t filesPerRead = 32; // Файлов в одном пакете чтения
+};
+
+// Загружает корневые элементы tag из paths. Потоки по очереди забирают группы по filesPerRead
+// файлов, читают группу одним пакетом и разбирают её; результат i соответствует paths[i]
+template <class T>
+std::vector<BatchItem<T>> loadBatch(const std::vector<std::string>& paths, std::string_view tag, const BatchOptions& options = {}) {
+    std::vector<BatchItem<T>> items(paths.size());
+    const std::size_t group = std::max<std::size_t>(options.filesPerRead, 1);
+    std::atomic<std::size_t> next{0};
+    auto worker = [&] {
+        FileReader reader{static_cast<unsigned>(group)};
+        std::vector<FileReader::File> files;
+        for(std::size_t begin; (begin = next.fetch_add(group, std::memory_order_relaxed)) < paths.size();) {
+            const std::size_t count = std::min(group, paths.size() - begin);
+            reader.read({paths.data() + begin, count}, files);
+            for(std::size_t i = 0; i < count; ++i) {
+                BatchItem<T>& item = items[begin + i];
+                if(!files[i].error.empty()) {
+                    item.error = std::move(files[i].error);
+                    continue;
+                }
+                try {
+                    item.value.emplace(readRecord<T>(files[i].content, tag));
+                } catch(const std::exception& e) {
+                    item.error = e.what();
+                }
+            }
+        }
+    };
+
+    const std::size_t groups = (paths.size() + group - 1) / group;
+    const unsigned cores = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    const unsigned threads = static_cast<unsigned>(std::min<std::size_t>(cores, groups));
+    std::vector<std::thread> pool;
+    for(unsigned i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for(auto& thread: pool) thread.join();
+    return items;
+}
+)"sv;
+
+constexpr auto batchDefinition = R"(namespace {
+
+// Чтение файла целиком без io_uring
+void readPlain(const std::string& path, FileReader::File& file) {
+    std::ifstream input(path, std::ios::binary);
+    if(!input) {
+        file.error = "Failed to open " + path;
+        return;
+    }
+    try {
+        file.content.assign(std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{});
+    } catch(const std::exception& e) {
+        // libstdc++ сообщает об ошибке чтения (например, каталога) исключением
+        file.content.clear();
+        file.error = "Failed to read " + path + ": " + e.what();
+        return;
+    }
+    if(input.bad()) file.error = "Failed to read " + path;
+}
+
+} // namespace
+
+#if XSD_IO_URING
+namespace {
+
+std::string systemError(int code) {
+    return std::error_code{code, std::generic_category()}.message();
+}
+
+} // namespace
+
+// Кольцо io_uring через системные вызовы (без liburing): очередь запросов и очередь завершений
+struct FileReader::Ring {
+    int fd = -1;
+    unsigned entries = 0;
+    void* sqRing = MAP_FAILED;
+    void* cqRing = MAP_FAILED;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    std::size_t sqSize = 0, cqSize = 0, sqesSize = 0;
+    unsigned *sqTail = nullptr, *sqMask = nullptr, *sqArray = nullptr;
+    unsigned *cqHead = nullptr, *cqTail = nullptr, *cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned queued = 0; // Поставлены в очередь, но ещё не переданы ядру
+    std::vector<std::string> abandoned; // Буферы запросов, брошенных вместе с кольцом
+
+    explicit Ring(unsigned depth) {
+        io_uring_params params{};
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, depth, &params));
+        if(fd < 0) return;
+        entries = params.sq_entries;
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqRing = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        cqRing = mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if(!valid()) return;
+        auto* sq = static_cast<char*>(sqRing);
+        auto* cq = static_cast<char*>(cqRing);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    ~Ring() {
+        if(sqes != MAP_FAILED) munmap(sqes, sqesSize);
+        if(cqRing != MAP_FAILED) munmap(cqRing, cqSize);
+        if(sqRing != MAP_FAILED) munmap(sqRing, sqSize);
+        if(fd >= 0) close(fd);
+    }
+
+    bool valid() const { return fd >= 0 && sqRing != MAP_FAILED && cqRing != MAP_FAILED && sqes != MAP_FAILED; }
+
+    // Запрос чтения size байт со смещения offset; tag возвращается в завершении
+    void pushRead(int file, char* buffer, std::size_t size, std::uint64_t offset, std::uint64_t tag) {
+        const unsigned tail = *sqTail; // Хвост очереди запросов пишет только этот поток
+        const unsigned index = tail & *sqMask;
+        io_uring_sqe& sqe = sqes[index];
+        sqe = {};
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = file;
+        sqe.addr = reinterpret_cast<std::uint64_t>(buffer);
+        sqe.len = static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30));
+        sqe.off = offset;
+        sqe.user_data = tag;
+        sqArray[index] = index;
+        std::atomic_ref{*sqTail}.store(tail + 1, std::memory_order_release);
+        ++queued;
+    }
+
+    // Передаёт ядру поставленные запросы и ждёт хотя бы одного завершения;
+    // false - кольцо неработоспособно (EFAULT, ENOMEM, запрет seccomp и т.п.)
+    bool submitAndWait() {
+        while(true) {
+            const long submitted = syscall(__NR_io_uring_enter, fd, queued, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if(submitted >= 0) {
+                queued -= static_cast<unsigned>(submitted);
+                return true;
+            }
+            if(errno != EINTR && errno != EAGAIN && errno != EBUSY) return false;
+        }
+    }
+
+    // Следующее завершение; false - очередь завершений пуста
+    bool pop(io_uring_cqe& cqe) {
+        const unsigned head = *cqHead;
+        if(head == std::atomic_ref{*cqTail}.load(std::memory_order_acquire)) return false;
+        cqe = cqes[head & *cqMask];
+        std::atomic_ref{*cqHead}.store(head + 1, std::memory_order_release);
+        return true;
+    }
+};
+#else
+struct FileReader::Ring {};
+#endif
+
+FileReader::FileReader([[maybe_unused]] unsigned depth) {
+#if XSD_IO_URING
+    auto ring = std::make_unique<Ring>(std::max(depth, 1u));
+    if(ring->valid()) ring_ = std::move(ring);
+#endif
+}
+
+FileReader::~FileReader() = default;
+
+void FileReader::read(std::span<const std::string> paths, std::vector<File>& files) {
+    files.assign(paths.size(), {});
+    if(!ring_) {
+        for(std::size_t i = 0; i < paths.size(); ++i) readPlain(paths[i], files[i]);
+        return;
+    }
+#if XSD_IO_URING
+    // Открытие и размер - по одному вызову на файл, чтение всей группы - общими пакетами
+    std::vector<int> fds(paths.size(), -1);
+    std::vector<std::size_t> done(paths.size(), 0);
+    unsigned inFlight = 0;
+    auto finish = [&](std::size_t i) {
+        close(fds[i]);
+        fds[i] = -1;
+    };
+    // Отказ io_uring_enter: запросы, уже переданные ядру, не отменить, и они могут ещё писать
+    // в свои буферы, поэтому кольцо и буферы намеренно не освобождаются. Незавершённые файлы
+    // и остаток пакета читаются обычным способом, как при недоступном io_uring
+    auto abandon = [&] {
+        Ring* ring = ring_.release();
+        for(std::size_t i = 0; i < paths.size(); ++i) {
+            if(fds[i] < 0) continue;
+            finish(i);
+            ring->abandoned.push_back(std::move(files[i].content));
+            files[i] = {};
+            readPlain(paths[i], files[i]);
+        }
+        inFlight = 0;
+    };
+    auto drain = [&](unsigned limit) {
+        while(inFlight > limit) {
+            if(!ring_->submitAndWait()) {
+                abandon();
+                return;
+            }
+            for(io_uring_cqe cqe; ring_->pop(cqe);) {
+                --inFlight;
+                const auto i = static_cast<std::size_t>(cqe.user_data);
+                File& file = files[i];
+                if(cqe.res == -EINTR || cqe.res == -EAGAIN) {
+                    ring_->pushRead(fds[i], file.content.data() + done[i], file.content.size() - done[i], done[i], i), ++inFlight;
+                } else if(cqe.res < 0) {
+                    // Ядро без IORING_OP_READ отвечает EINVAL: такой файл читается обычным способом
+                    finish(i);
+                    file = {};
+                    if(cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP) readPlain(paths[i], file);
+                    else file.error = "Failed to read " + paths[i] + ": " + systemError(-cqe.res);
+                } else if(cqe.res == 0) {
+                    // Файл укоротился после fstat
+                    file.content.resize(done[i]);
+                    finish(i);
+                } else if((done[i] += static_cast<std::size_t>(cqe.res)) < file.content.size()) {
+                    ring_->pushRead(fds[i], file.content.data() + done[i], file.content.size() - done[i], done[i], i), ++inFlight;
+                } else {
+                    finish(i);
+                }
+            }
+        }
+    };
+
+    for(std::size_t i = 0; i < paths.size(); ++i) {
+        if(!ring_) {
+            readPlain(paths[i], files[i]);
+            continue;
+        }
+        fds[i] = open(paths[i].c_str(), O_RDONLY | O_CLOEXEC);
+        if(fds[i] < 0) {
+            files[i].error = "Failed to open " + paths[i] + ": " + systemError(errno);
+            continue;
+        }
+        struct stat info {};
+        if(fstat(fds[i], &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+            // Каналы и специальные файлы не сообщают размер заранее
+            finish(i);
+            readPlain(paths[i], files[i]);
+            continue;
+        }
+        files[i].content.resize(static_cast<std::size_t>(info.st_size));
+        drain(ring_->entries - 1);
+        if(!ring_) continue; // Файл уже прочитан обычным способом
+        ring_->pushRead(fds[i], files[i].content.data(), files[i].content.size(), 0, i), ++inFlight;
+    }
+    if(ring_) drain(0);
+#endif
+}
+)"sv;
+
+} // namespace
+
+// Пакетная загрузка множества файлов одной схемы (Options::batch)
+bool Parser::generateBatch(const string& outputDir, const string& namespaceName) const {
+    std::ofstream header(outputDir + "/Batch.h");
+    if(!header.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Batch.h", outputDir);
+        return false;
+    }
+
+    println(header, "#pragma once\n");
+    println(header, "#include <algorithm>");
+    println(header, "#include <atomic>");
+    println(header, "#include <cstddef>");
+    println(header, "#include <memory>");
+    println(header, "#include <optional>");
+    println(header, "#include <span>");
+    println(header, "#include <string>");
+    println(header, "#include <string_view>");
+    println(header, "#include <thread>");
+    println(header, "#include <vector>");
+    println(header, "#include \"Reader.h\"\n");
+    if(!namespaceName.empty()) {
+        println(header, "namespace {} {{\n", namespaceName);
+    }
+    header << batchDeclaration;
+    if(!namespaceName.empty()) {
+        println(header, "\n}} // namespace {}", namespaceName);
+    }
+    header.close();
+
+    std::ofstream source(outputDir + "/Batch.cpp");
+    if(!source.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Batch.cpp", outputDir);
+        return false;
+    }
+
+    println(source, "#include \"Batch.h\"");
+    println(source, "#include <exception>");
+    println(source, "#include <fstream>");
+    println(source, "#include <iterator>");
+    println(source, "#include <system_error>\n");
+    println(source, "#if defined(__linux__) && __has_include(<linux/io_uring.h>)");
+    println(source, "#define XSD_IO_URING 1");
+    println(source, "#include <cerrno>");
+    println(source, "#include <fcntl.h>");
+    println(source, "#include <linux/io_uring.h>");
+    println(source, "#include <sys/mman.h>");
+    println(source, "#include <sys/stat.h>");
+    println(source, "#include <sys/syscall.h>");
+    println(source, "#include <unistd.h>");
+    println(source, "#else");
+    println(source, "#define XSD_IO_URING 0");
+    println(source, "#endif\n");
+    if(!namespaceName.empty()) {
+        println(source, "namespace {} {{\n", namespaceName);
+    }
+    source << batchDefinition;
+    if(!namespaceName.empty()) {
+        println(source, "\n}} // namespace {}", namespaceName);
+    }
+    return true;
+}
+
+} // namespace Xsd
@@ -0,0 +1,197 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Подсчёт выделений памяти и замер этапов (Bench.cpp)
+constexpr auto benchRuntime = R"(
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> allocatedBytes{0};
+
+// Результат этапа: лучшее время из повторов, выделения - на один повтор
+struct Stage {
+    const char* name;
+    std::size_t bytes; // Объём обработанного XML
+    double seconds;
+    std::size_t allocations;
+    std::size_t allocatedBytes;
+};
+
+template <class F>
+Stage measure(const char* name, std::size_t bytes, int repeats, F&& body) {
+    double best = std::numeric_limits<double>::infinity();
+    const std::size_t count = allocations.load(std::memory_order_relaxed);
+    const std::size_t total = allocatedBytes.load(std::memory_order_relaxed);
+    for(int i = 0; i < repeats; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return {name, bytes, best,
+        (allocations.load(std::memory_order_relaxed) - count) / repeats,
+        (allocatedBytes.load(std::memory_order_relaxed) - total) / repeats};
+}
+
+void printStage(const Stage& stage) {
+    std::printf("  %-10s %9.1f MB/s %10.3f ms %10zu allocations %10.1f KB\n",
+        stage.name, stage.bytes / stage.seconds / 1e6, stage.seconds * 1e3, stage.allocations, stage.allocatedBytes / 1024.0);
+}
+
+// Пиковый резидентный объём процесса, байт; 0 - неизвестен
+std::size_t peakRss() {
+#if defined(__APPLE__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#elif defined(__unix__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#else
+    return 0;
+#endif
+}
+
+std::string readFile(const char* path) {
+    std::ifstream file(path, std::ios::binary);
+    if(!file) throw std::runtime_error(std::string{"Failed to open "} + path);
+    return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+// Загрузка, проверка, сериализация и повторная загрузка одного файла
+bool run(const char* path, int repeats) {
+    const std::string xml = readFile(path);
+    std::printf("%s: %zu bytes, best of %d\n", path, xml.size(), repeats);
+
+    std::optional<Document<Root>> document;
+    const Stage load = measure("load", xml.size(), repeats, [&] { document = parseDocument<Root>(xml, rootTag); });
+
+    std::size_t violations = 0;
+    const Stage check = measure("validate", xml.size(), repeats, [&] { violations = validate(document->root, rootTag).size(); });
+
+    std::string text;
+    const Stage serialize = measure("serialize", xml.size(), repeats, [&] { text = toXml(document->root, rootTag); });
+
+    // Повторная загрузка сериализованного документа должна давать тот же XML
+    std::string again;
+    const Stage roundTrip = measure("round-trip", xml.size(), repeats, [&] {
+        again = toXml(parseDocument<Root>(text, rootTag).root, rootTag);
+    });
+
+    printStage(load), printStage(check), printStage(serialize), printStage(roundTrip);
+    std::printf("  violations: %zu\n", violations);
+    if(again != text) {
+        std::printf("  round-trip mismatch\n");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// Выделения считаются во всей программе, включая tinyxml2.
+// GCC, встроив замену operator delete, принимает пару malloc/free за несогласованную
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if(void* pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+int main(int argc, char* argv[]) {
+    int repeats = 5;
+    std::vector<const char*> files;
+    for(int i = 1; i < argc; ++i) {
+        if(std::string_view{argv[i]} == "-n" && i + 1 < argc) repeats = std::max(1, std::atoi(argv[++i]));
+        else files.push_back(argv[i]);
+    }
+    if(files.empty()) {
+        std::fprintf(stderr, "Usage: %s [-n repeats] instance.xml...\n", argv[0]);
+        return 2;
+    }
+
+    bool ok = true;
+    for(const char* path: files) {
+        try {
+            ok = run(path, repeats) && ok;
+        } catch(const std::exception& e) {
+            std::fprintf(stderr, "%s: %s\n", path, e.what());
+            ok = false;
+        }
+    }
+    if(const std::size_t rss = peakRss()) std::printf("peak RSS: %.1f MB\n", rss / 1e6);
+    return ok ? 0 : 1;
+}
+)"sv;
+
+} // namespace
+
+// Корневой элемент документа: первый глобальный элемент со сгенерированной структурой
+const Element* Parser::rootElement() const {
+    for(const auto& element: elements) {
+        const string type = convertXsdTypeToCpp(element.type);
+        if(std::ranges::any_of(complexTypes, [&](const ComplexType& complexType) { return complexType.name == type; }))
+            return &element;
+    }
+    return nullptr;
+}
+
+// Программа замера производительности сгенерированных привязок (Options::bench)
+bool Parser::generateBench(const string& outputDir, const string& namespaceName) const {
+    const Element* root = rootElement();
+    if(!root) {
+        println(std::cout, "  Предупреждение: нет глобального элемента со структурой, Bench.cpp не создаётся");
+        return true;
+    }
+
+    std::ofstream source(outputDir + "/Bench.cpp");
+    if(!source.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Bench.cpp", outputDir);
+        return false;
+    }
+
+    println(source, "// Замер загрузки, проверки, сериализации и повторной загрузки экземпляров схемы.");
+    println(source, "// Использование: xsd_generated_bench [-n повторов] файл.xml...\n");
+    println(source, "#include \"Reader.h\"");
+    println(source, "#include \"Validate.h\"");
+    println(source, "#include \"Writer.h\"");
+    println(source, "#include <algorithm>");
+    println(source, "#include <atomic>");
+    println(source, "#include <chrono>");
+    println(source, "#include <cstdio>");
+    println(source, "#include <cstdlib>");
+    println(source, "#include <fstream>");
+    println(source, "#include <iterator>");
+    println(source, "#include <limits>");
+    println(source, "#include <new>");
+    println(source, "#include <optional>");
+    println(source, "#include <string>");
+    println(source, "#include <string_view>");
+    println(source, "#include <vector>");
+    println(source, "#if defined(__unix__) || defined(__APPLE__)");
+    println(source, "#include <sys/resource.h>");
+    println(source, "#endif\n");
+
+    println(source, "namespace {{\n");
+    if(!namespaceName.empty()) {
+        println(source, "using namespace {};\n", namespaceName);
+    }
+    println(source, "using Root = {}::{};", namespaceName.empty() ? "" : "::" + namespaceName, convertXsdTypeToCpp(root->type));
+    println(source, "constexpr std::string_view rootTag = \"{}\";", root->xmlName);
+    source << benchRuntime;
+    return true;
+}
+
+} // namespace Xsd
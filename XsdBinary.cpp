@@ -0,0 +1,676 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+#include <sstream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Формат файла, кодировщик и доступ к данным на месте (Binary.h)
+constexpr auto runtimeDeclaration = R"(namespace binary {
+
+// Заголовок файла. Смещения записей - от начала файла, строк - от начала таблицы строк.
+// Числа хранятся с порядком байт платформы, без выравнивания (чтение через memcpy).
+struct Header {
+    char magic[4];             // "XSDB"
+    std::uint32_t version;     // Версия формата
+    std::uint32_t schemaHash;  // Отпечаток схемы, под которую сгенерирован код
+    std::uint32_t root;        // Смещение корневой записи
+    std::uint32_t strings;     // Смещение таблицы строк
+    std::uint32_t stringsSize; // Размер таблицы строк
+};
+
+template <class T>
+T read(const char* base, std::uint32_t offset) {
+    T value;
+    std::memcpy(&value, base + offset, sizeof(T));
+    return value;
+}
+
+inline std::string_view readString(const char* base, std::uint32_t offset) {
+    const auto strings = read<std::uint32_t>(base, offsetof(Header, strings));
+    return {base + strings + read<std::uint32_t>(base, offset), read<std::uint32_t>(base, offset + 4)};
+}
+
+// Бит присутствия необязательного поля в начале записи
+inline bool present(const char* base, std::uint32_t record, unsigned bit) {
+    return read<std::uint32_t>(base, record + bit / 32 * 4) >> (bit % 32) & 1u;
+}
+
+// Чтение слота по типу значения: скаляры хранятся как есть,
+// строки - парой (смещение, длина), записи - смещением
+template <class T>
+struct Element;
+
+template <class T>
+    requires std::is_arithmetic_v<T>
+struct Element<T> {
+    static constexpr std::uint32_t size = sizeof(T);
+    static T get(const char* base, std::uint32_t offset) { return read<T>(base, offset); }
+};
+
+template <>
+struct Element<bool> {
+    static constexpr std::uint32_t size = 1;
+    static bool get(const char* base, std::uint32_t offset) { return read<std::uint8_t>(base, offset) != 0; }
+};
+
+template <class E>
+    requires std::is_enum_v<E>
+struct Element<E> {
+    static constexpr std::uint32_t size = 4;
+    static E get(const char* base, std::uint32_t offset) { return static_cast<E>(read<std::int32_t>(base, offset)); }
+};
+
+template <>
+struct Element<std::string_view> {
+    static constexpr std::uint32_t size = 8;
+    static std::string_view get(const char* base, std::uint32_t offset) { return readString(base, offset); }
+};
+
+template <class V>
+    requires requires { typename V::ViewTag; }
+struct Element<V> {
+    static constexpr std::uint32_t size = 4;
+    static V get(const char* base, std::uint32_t offset) { return V{base, read<std::uint32_t>(base, offset)}; }
+};
+
+// Массив в файле: слот хранит смещение и число элементов
+template <class T>
+class ArrayView {
+public:
+    class iterator {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        iterator() = default;
+        iterator(const ArrayView* view, std::size_t index)
+            : view_{view}
+            , index_{index} { }
+        T operator*() const { return (*view_)[index_]; }
+        iterator& operator++() { return ++index_, *this; }
+        iterator operator++(int) { return {view_, index_++}; }
+        bool operator==(const iterator& other) const { return index_ == other.index_; }
+
+    private:
+        const ArrayView* view_{};
+        std::size_t index_{};
+    };
+
+    ArrayView() = default;
+    ArrayView(const char* base, std::uint32_t slot)
+        : base_{base}
+        , offset_{read<std::uint32_t>(base, slot)}
+        , size_{read<std::uint32_t>(base, slot + 4)} { }
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T operator[](std::size_t index) const {
+        return Element<T>::get(base_, offset_ + static_cast<std::uint32_t>(index) * Element<T>::size);
+    }
+    iterator begin() const { return {this, 0}; }
+    iterator end() const { return {this, size_}; }
+
+private:
+    const char* base_{};
+    std::uint32_t offset_{};
+    std::uint32_t size_{};
+};
+
+// Размер слота элемента массива при кодировании
+template <class T>
+constexpr std::uint32_t slotSize() {
+    if constexpr(std::is_same_v<T, bool>) return 1;
+    else if constexpr(std::is_arithmetic_v<T>) return sizeof(T);
+    else if constexpr(std::is_enum_v<T>) return 4;
+    else return 8;
+}
+
+// Кодировщик: записи дописываются в конец, вложенные - раньше родительских,
+// строки собираются в таблицу без повторов
+class Encoder {
+public:
+    Encoder();
+
+    // Новая запись заданного размера, заполненная нулями
+    std::uint32_t record(std::size_t size);
+    void setPresent(std::uint32_t record, unsigned bit);
+
+    template <class T>
+        requires std::is_arithmetic_v<T>
+    void put(std::uint32_t offset, T value) {
+        std::memcpy(data_.data() + offset, &value, sizeof(T));
+    }
+    void put(std::uint32_t offset, bool value) { put(offset, static_cast<std::uint8_t>(value)); }
+    template <class E>
+        requires std::is_enum_v<E>
+    void put(std::uint32_t offset, E value) {
+        put(offset, static_cast<std::int32_t>(value));
+    }
+    void put(std::uint32_t offset, std::string_view value) { putString(offset, value); }
+    void put(std::uint32_t offset, const std::vector<unsigned char>& value) {
+        putString(offset, {reinterpret_cast<const char*>(value.data()), value.size()});
+    }
+    void put(std::uint32_t offset, std::pair<std::uint32_t, std::uint32_t> array) {
+        put(offset, array.first), put(offset + 4, array.second);
+    }
+
+    // Кодирует массив (std::vector или Lazy), возвращает (смещение, число элементов)
+    template <class Range, class T = std::ranges::range_value_t<Range>>
+    std::pair<std::uint32_t, std::uint32_t> array(const Range& items) {
+        const auto count = checkedOffset(items.size());
+        if constexpr(requires(Encoder& encoder, const T& item) { encodeBinary(encoder, item); }) {
+            std::vector<std::uint32_t> records;
+            records.reserve(items.size());
+            for(const auto& item: items) records.push_back(encodeBinary(*this, item));
+            const auto offset = record(items.size() * 4);
+            for(std::uint32_t i = 0; i < count; ++i) put(offset + i * 4, records[i]);
+            return {offset, count};
+        } else {
+            const auto offset = record(items.size() * slotSize<T>());
+            for(std::uint32_t i = 0; i < count; ++i) put(offset + i * slotSize<T>(), items[i]);
+            return {offset, count};
+        }
+    }
+
+    // Завершает файл: дописывает таблицу строк и заголовок
+    std::string finish(std::uint32_t root);
+
+private:
+    void putString(std::uint32_t offset, std::string_view value);
+
+    // Смещения и размеры в файле 32-разрядные: модель больше 4 ГиБ не кодируется
+    static std::uint32_t checkedOffset(std::size_t value) {
+        if(value > std::numeric_limits<std::uint32_t>::max())
+            throw std::length_error("Binary encoding exceeds 4 GiB");
+        return static_cast<std::uint32_t>(value);
+    }
+
+    std::string data_;
+    std::string strings_;
+    std::unordered_map<std::string, std::uint32_t> index_;
+};
+
+// Файл, отображённый в память только для чтения
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    void reset();
+
+    const char* data_{};
+    std::size_t size_{};
+    std::vector<char> buffer_; // Без mmap файл читается целиком
+};
+
+} // namespace binary
+)"sv;
+
+constexpr auto documentHelpers = R"(// Бинарный документ: проверяет заголовок и даёт доступ к данным без копирования
+class BinaryDocument {
+public:
+    explicit BinaryDocument(const std::string& path);
+
+    template <class View>
+    View root() const { return View{file_.data(), header().root}; }
+
+    const char* data() const { return file_.data(); }
+    std::size_t size() const { return file_.size(); }
+
+private:
+    binary::Header header() const { return binary::read<binary::Header>(file_.data(), 0); }
+
+    binary::MappedFile file_;
+};
+
+// Кодирует документ в бинарный формат
+template <class T>
+std::string encodeDocument(const T& root) {
+    binary::Encoder encoder;
+    const auto offset = encodeBinary(encoder, root);
+    return encoder.finish(offset);
+}
+
+// Сохраняет документ в бинарном формате, возвращает false при ошибке записи
+template <class T>
+bool saveBinary(const T& root, const std::string& path) {
+    const std::string data = encodeDocument(root);
+    std::ofstream file(path, std::ios::binary);
+    return file.write(data.data(), static_cast<std::streamsize>(data.size())).good();
+}
+)"sv;
+
+constexpr auto runtimeDefinition = R"(namespace binary {
+
+Encoder::Encoder()
+    : data_(sizeof(Header), '\0') { }
+
+std::uint32_t Encoder::record(std::size_t size) {
+    const auto offset = checkedOffset(data_.size());
+    checkedOffset(data_.size() + size);
+    data_.resize(data_.size() + size);
+    return offset;
+}
+
+void Encoder::setPresent(std::uint32_t record, unsigned bit) {
+    const std::uint32_t offset = record + bit / 32 * 4;
+    put(offset, read<std::uint32_t>(data_.data(), offset) | 1u << bit % 32);
+}
+
+void Encoder::putString(std::uint32_t offset, std::string_view value) {
+    const auto length = checkedOffset(value.size());
+    auto [it, inserted] = index_.try_emplace(std::string{value}, checkedOffset(strings_.size()));
+    if(inserted) {
+        checkedOffset(strings_.size() + value.size());
+        strings_.append(value);
+    }
+    put(offset, it->second);
+    put(offset + 4, length);
+}
+
+std::string Encoder::finish(std::uint32_t root) {
+    Header header{
+        {'X', 'S', 'D', 'B'},
+        formatVersion,
+        schemaHash,
+        root,
+        checkedOffset(data_.size()),
+        checkedOffset(strings_.size()),
+    };
+    std::memcpy(data_.data(), &header, sizeof(header));
+    data_ += strings_;
+    return std::move(data_);
+}
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file) throw std::runtime_error("Failed to open " + path);
+    buffer_.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0).read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) throw std::runtime_error("Failed to open " + path);
+    struct stat info{};
+    if(::fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to map " + path);
+    }
+    void* mapped = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(mapped == MAP_FAILED) throw std::runtime_error("Failed to map " + path);
+    data_ = static_cast<const char*>(mapped);
+    size_ = static_cast<std::size_t>(info.st_size);
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}
+    , size_{std::exchange(other.size_, 0)}
+    , buffer_{std::move(other.buffer_)} { }
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if(this != &other) {
+        reset();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() { reset(); }
+
+void MappedFile::reset() {
+#ifndef _WIN32
+    if(data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    buffer_.clear();
+}
+
+} // namespace binary
+
+BinaryDocument::BinaryDocument(const std::string& path)
+    : file_{path} {
+    if(file_.size() < sizeof(binary::Header)) throw std::runtime_error("Not a binary document: " + path);
+    const auto info = header();
+    if(std::string_view{info.magic, 4} != "XSDB" || info.version != binary::formatVersion)
+        throw std::runtime_error("Unsupported binary document: " + path);
+    if(info.schemaHash != binary::schemaHash)
+        throw std::runtime_error("Binary document was built for another schema: " + path);
+    if(info.root >= info.strings || std::size_t{info.strings} + info.stringsSize > file_.size())
+        throw std::runtime_error("Corrupted binary document: " + path);
+}
+)"sv;
+
+constexpr auto fileIncludes = R"(#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+)"sv;
+
+// Слот поля в записи фиксированного размера
+struct Slot {
+    const Field* field;
+    uint32_t offset;
+    int presenceBit; // -1 для обязательных полей и массивов
+};
+
+uint32_t scalarSize(const string& type) {
+    static const std::map<string, uint32_t, std::less<>> sizes{
+        {"bool",     1},
+        {"int8_t",   1},
+        {"uint8_t",  1},
+        {"int16_t",  2},
+        {"uint16_t", 2},
+        {"int32_t",  4},
+        {"uint32_t", 4},
+        {"float",    4},
+        {"int64_t",  8},
+        {"uint64_t", 8},
+        {"double",   8},
+    };
+    auto it = sizes.find(type);
+    return it != sizes.end() ? it->second : 8;
+}
+
+uint32_t slotSize(const Field& field) {
+    if(field.isRepeated()) return 8; // Смещение и число элементов
+    switch(field.kind) {
+    case Field::Kind::String:
+    case Field::Kind::Binary: return 8;
+    case Field::Kind::Scalar: return scalarSize(field.type);
+    case Field::Kind::Enum:
+    case Field::Kind::Complex: return 4;
+    }
+    return 8;
+}
+
+// Раскладка записи: слова битов присутствия, затем слоты полей в порядке схемы
+vector<Slot> layout(const ComplexType& complexType, uint32_t& recordSize) {
+    vector<Slot> slots;
+    int optionalCount = 0;
+    for(const auto& field: complexType.fields) {
+        int bit = field.isOptional && !field.isRepeated() ? optionalCount++ : -1;
+        slots.push_back({&field, 0, bit});
+    }
+
+    uint32_t offset = (optionalCount + 31) / 32 * 4;
+    for(auto& slot: slots) {
+        slot.offset = offset;
+        offset += slotSize(*slot.field);
+    }
+    recordSize = offset;
+    return slots;
+}
+
+// Тип значения поля при чтении на месте.
+// Перечисления квалифицируются: аксессор может совпадать с именем типа
+string viewType(const Field& field, const string& namespaceName) {
+    switch(field.kind) {
+    case Field::Kind::String:
+    case Field::Kind::Binary: return "std::string_view";
+    case Field::Kind::Complex: return field.type + "View";
+    case Field::Kind::Enum: return "::" + namespaceName + (namespaceName.empty() ? "" : "::") + field.type;
+    default: return field.type;
+    }
+}
+
+// Преобразование значения из представления в поле структуры
+string decodeValue(const Field& field, const string& item) {
+    switch(field.kind) {
+    case Field::Kind::String: return std::format("{}{{{}}}", field.type, item);
+    case Field::Kind::Binary: return std::format("std::vector<unsigned char>({0}.begin(), {0}.end())", item);
+    case Field::Kind::Complex: return std::format("{}.decode()", item);
+    default: return item;
+    }
+}
+
+} // namespace
+
+string ComplexType::generateBinaryView(const string& namespaceName) const {
+    std::stringstream ss;
+
+    uint32_t recordSize = 0;
+    auto slots = layout(*this, recordSize);
+
+    println(ss, "// Запись {} в бинарном документе ({} байт)", name, recordSize);
+    println(ss, "class {}View {{", name);
+    println(ss, "public:");
+    println(ss, "    using ViewTag = void;");
+    // Квалифицированное имя: аксессор может совпадать с именем типа
+    println(ss, "    using Object = ::{}{}{};", namespaceName, namespaceName.empty() ? "" : "::", name);
+    println(ss, "    {}View() = default;", name);
+    println(ss, "    {}View(const char* base, std::uint32_t offset)", name);
+    println(ss, "        : base_{{base}}");
+    println(ss, "        , offset_{{offset}} {{ }}\n");
+
+    for(const auto& slot: slots) {
+        const Field& field = *slot.field;
+        if(field.isRepeated())
+            println(ss, "    binary::ArrayView<{}> {}() const;", viewType(field, namespaceName), field.name);
+        else if(slot.presenceBit >= 0)
+            println(ss, "    std::optional<{}> {}() const;", viewType(field, namespaceName), field.name);
+        else
+            println(ss, "    {} {}() const;", viewType(field, namespaceName), field.name);
+    }
+
+    println(ss, "\n    // Полное декодирование в структуру Types.h");
+    println(ss, "    Object decode() const;\n");
+    println(ss, "private:");
+    println(ss, "    const char* base_{{}};");
+    println(ss, "    std::uint32_t offset_{{}};");
+    println(ss, "}};\n");
+
+    return ss.str();
+}
+
+string ComplexType::generateBinaryAccessors(const string& namespaceName) const {
+    std::stringstream ss;
+
+    uint32_t recordSize = 0;
+    for(const auto& slot: layout(*this, recordSize)) {
+        const Field& field = *slot.field;
+        const string type = viewType(field, namespaceName);
+
+        if(field.isRepeated()) {
+            println(ss, "inline binary::ArrayView<{0}> {1}View::{2}() const {{ return {{base_, offset_ + {3}}}; }}",
+                type, name, field.name, slot.offset);
+        } else if(slot.presenceBit >= 0) {
+            println(ss, "inline std::optional<{}> {}View::{}() const {{", type, name, field.name);
+            println(ss, "    if(!binary::present(base_, offset_, {})) return std::nullopt;", slot.presenceBit);
+            println(ss, "    return binary::Element<{}>::get(base_, offset_ + {});", type, slot.offset);
+            println(ss, "}}");
+        } else {
+            println(ss, "inline {0} {1}View::{2}() const {{ return binary::Element<{0}>::get(base_, offset_ + {3}); }}",
+                type, name, field.name, slot.offset);
+        }
+    }
+    println(ss, "");
+
+    return ss.str();
+}
+
+string ComplexType::generateBinaryCode() const {
+    std::stringstream ss;
+
+    uint32_t recordSize = 0;
+    auto slots = layout(*this, recordSize);
+
+    // Кодирование: вложенные записи и массивы пишутся до родительской записи
+    // У структуры без полей value не используется
+    println(ss, "std::uint32_t encodeBinary(binary::Encoder& encoder, {}const {}& value) {{", slots.empty() ? "[[maybe_unused]] " : "", name);
+    for(size_t i = 0; i < slots.size(); ++i) {
+        const Field& field = *slots[i].field;
+        if(field.isRepeated())
+            println(ss, "    const auto child{} = encoder.array(value.{});", i, field.name);
+        else if(field.kind != Field::Kind::Complex)
+            continue;
+        else if(slots[i].presenceBit >= 0)
+            println(ss, "    const std::uint32_t child{0} = value.{1} ? encodeBinary(encoder, *value.{1}) : 0;", i, field.name);
+        else
+            println(ss, "    const std::uint32_t child{} = encodeBinary(encoder, value.{});", i, field.name);
+    }
+
+    println(ss, "    const auto record = encoder.record({});", recordSize);
+    for(size_t i = 0; i < slots.size(); ++i) {
+        const auto& [field, offset, bit] = slots[i];
+        const bool isChild = field->isRepeated() || field->kind == Field::Kind::Complex;
+        const string item = isChild ? std::format("child{}", i) : std::format("*value.{}", field->name);
+        if(bit >= 0) {
+            println(ss, "    if(value.{}) {{", field->name);
+            println(ss, "        encoder.setPresent(record, {});", bit);
+            println(ss, "        encoder.put(record + {}, {});", offset, item);
+            println(ss, "    }}");
+        } else {
+            println(ss, "    encoder.put(record + {}, {});", offset, isChild ? item : "value." + field->name);
+        }
+    }
+    println(ss, "    return record;");
+    println(ss, "}}\n");
+
+    // Полное декодирование; аксессоры вызываются через this->, поле может называться value
+    println(ss, "{0} {0}View::decode() const {{", name);
+    println(ss, "    Object value;");
+    for(const auto& slot: slots) {
+        const Field& field = *slot.field;
+        if(field.isRepeated()) {
+            println(ss, "    {{");
+            println(ss, "        const auto items = this->{}();", field.name);
+            println(ss, "        value.{}.reserve(items.size());", field.name);
+            println(ss, "        for(auto item: items) value.{}.push_back({});", field.name, decodeValue(field, "item"));
+            println(ss, "    }}");
+        } else if(slot.presenceBit >= 0) {
+            println(ss, "    if(auto item = this->{}()) value.{} = {};", field.name, field.name, decodeValue(field, "(*item)"));
+        } else {
+            println(ss, "    value.{} = {};", field.name, decodeValue(field, "this->" + field.name + "()"));
+        }
+    }
+    if(!constraints.empty()) {
+        println(ss, "    value.rebuildIndexes();");
+    }
+    println(ss, "    return value;");
+    println(ss, "}}\n");
+
+    return ss.str();
+}
+
+bool Parser::generateBinary(const string& outputDir, const string& namespaceName) const {
+    // Отпечаток схемы (FNV-1a по раскладке записей) защищает от чтения чужих файлов
+    uint32_t schemaHash = 2166136261u;
+    auto hash = [&schemaHash](string_view text) {
+        for(unsigned char c: text) schemaHash = (schemaHash ^ c) * 16777619u;
+    };
+    for(const auto& complexType: complexTypes) {
+        hash(complexType.name);
+        for(const auto& field: complexType.fields) {
+            hash(std::format("{}:{}:{}:{}:{};", field.name, field.type, int(field.kind), field.maxOccurs, field.isOptional));
+        }
+    }
+
+    std::ofstream header(outputDir + "/Binary.h");
+    if(!header.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Binary.h", outputDir);
+        return false;
+    }
+
+    println(header, "#pragma once\n");
+    println(header, "#include <cstddef>");
+    println(header, "#include <cstdint>");
+    println(header, "#include <cstring>");
+    println(header, "#include <fstream>");
+    println(header, "#include <limits>");
+    println(header, "#include <optional>");
+    println(header, "#include <ranges>");
+    println(header, "#include <stdexcept>");
+    println(header, "#include <string>");
+    println(header, "#include <string_view>");
+    println(header, "#include <type_traits>");
+    println(header, "#include <unordered_map>");
+    println(header, "#include <utility>");
+    println(header, "#include <vector>");
+    println(header, "#include \"Types.h\"\n");
+
+    if(!namespaceName.empty()) {
+        println(header, "namespace {} {{\n", namespaceName);
+    }
+
+    println(header, "namespace binary {{");
+    println(header, "inline constexpr std::uint32_t formatVersion = 1;");
+    println(header, "inline constexpr std::uint32_t schemaHash = {:#010x};", schemaHash);
+    println(header, "}} // namespace binary\n");
+
+    header << runtimeDeclaration << '\n';
+
+    for(const auto& complexType: complexTypes) {
+        println(header, "class {}View;", complexType.name);
+    }
+    println(header, "");
+
+    for(const auto& complexType: complexTypes) {
+        header << complexType.generateBinaryView(namespaceName);
+    }
+
+    for(const auto& complexType: complexTypes) {
+        header << complexType.generateBinaryAccessors(namespaceName);
+    }
+
+    for(const auto& complexType: complexTypes) {
+        println(header, "std::uint32_t encodeBinary(binary::Encoder& encoder, const {}& value);", complexType.name);
+    }
+    println(header, "");
+
+    header << documentHelpers;
+
+    if(!namespaceName.empty()) {
+        println(header, "\n}} // namespace {}", namespaceName);
+    }
+
+    header.close();
+
+    std::ofstream source(outputDir + "/Binary.cpp");
+    if(!source.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Binary.cpp", outputDir);
+        return false;
+    }
+
+    println(source, "#include \"Binary.h\"");
+    println(source, "#include <stdexcept>\n");
+    source << fileIncludes << '\n';
+
+    if(!namespaceName.empty()) {
+        println(source, "namespace {} {{\n", namespaceName);
+    }
+
+    source << runtimeDefinition << '\n';
+
+    for(const auto& complexType: complexTypes) {
+        source << complexType.generateBinaryCode();
+    }
+
+    if(!namespaceName.empty()) {
+        println(source, "}} // namespace {}", namespaceName);
+    }
+
+    source.close();
+    return true;
+}
+
+} // namespace Xsd
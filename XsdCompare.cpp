@@ -0,0 +1,133 @@
+#include "XsdParser.h"
+#include <format>
+#include <set>
+#include <sstream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Категория упорядочения: по возрастанию ослабляется при свёртке полей
+enum class Ordering {
+    Strong,  // std::strong_ordering
+    Partial, // std::partial_ordering - есть вещественные поля
+    None,    // operator<=> не генерируется: ленивые коллекции, разделяемые поддеревья
+};
+
+constexpr string_view orderingName(Ordering ordering) {
+    switch(ordering) {
+    case Ordering::Strong: return "std::strong_ordering"sv;
+    case Ordering::Partial: return "std::partial_ordering"sv;
+    default: return ""sv;
+    }
+}
+
+// Поле структуры from (непосредственно или через вложенные структуры) имеет тип target
+bool reaches(const std::map<string, const ComplexType*>& types, const string& from, const string& target, std::set<string>& visited) {
+    auto it = types.find(from);
+    if(it == types.end() || !visited.insert(from).second) return false;
+    return std::ranges::any_of(it->second->fields, [&](const Field& field) {
+        return field.kind == Field::Kind::Complex && (field.type == target || reaches(types, field.type, target, visited));
+    });
+}
+
+} // namespace
+
+// Тип результата operator<=> каждой структуры (Options::comparisons). Вложенные структуры,
+// в том числе рекурсивные, сводятся итерацией до неподвижной точки: категории только ослабляются
+void Parser::resolveOrderings() {
+    std::map<string, Ordering, std::less<>> orderings;
+    for(const auto& complexType: complexTypes) orderings[complexType.name] = Ordering::Strong;
+
+    auto orderingOf = [&](const Field& field) {
+        if(field.isShared || options_.isLazy(field)) return Ordering::None;
+        switch(field.kind) {
+        case Field::Kind::Scalar:
+            return field.type == "float" || field.type == "double" ? Ordering::Partial : Ordering::Strong;
+        case Field::Kind::Complex: {
+            auto it = orderings.find(field.type);
+            return it == orderings.end() ? Ordering::None : it->second;
+        }
+        default: return Ordering::Strong;
+        }
+    };
+
+    for(bool changed = true; changed;) {
+        changed = false;
+        for(const auto& complexType: complexTypes) {
+            Ordering ordering = Ordering::Strong;
+            for(const auto& field: complexType.fields) ordering = std::max(ordering, orderingOf(field));
+            auto& current = orderings[complexType.name];
+            if(ordering > current) {
+                current = ordering;
+                changed = true;
+            }
+        }
+    }
+
+    std::map<string, const ComplexType*> types;
+    for(const auto& complexType: complexTypes) types[complexType.name] = &complexType;
+    for(auto& complexType: complexTypes) {
+        complexType.ordering = orderingName(orderings[complexType.name]);
+        std::set<string> visited;
+        complexType.isRecursive = reaches(types, complexType.name, complexType.name, visited);
+    }
+}
+
+// Сравнение структуры (Types.h): по умолчанию - почленное в порядке объявления.
+// Индексы xs:key/xs:keyref производны от полей и не сравниваются, поэтому для структур
+// с ограничениями операторы пишутся явно. Рекурсивной структуре operator<=> по умолчанию
+// не подходит: проверка упорядочиваемости элементов коллекции зависела бы от него самого
+string ComplexType::generateComparisonDecl(const string& namespaceName) const {
+    std::stringstream ss;
+    const bool indexed = !constraints.empty();
+    // Поле с именем структуры скрывает её имя внутри структуры
+    const string self = std::ranges::any_of(fields, [this](const Field& field) { return field.name == name; })
+        ? (namespaceName.empty() ? "::" : "::" + namespaceName + "::") + name
+        : name;
+    println(ss, "\n    // Сравнение по полям в порядке объявления{}", indexed ? "; индексы не сравниваются" : "");
+    vector<const Field*> members;
+    for(size_t i = 0; i < fields.size(); ++i) members.push_back(&fields[memberOrder.empty() ? i : memberOrder[i]]);
+
+    if(!indexed) {
+        println(ss, "    bool operator==(const {}&) const = default;", self);
+    } else {
+        println(ss, "    bool operator==(const {}& other) const {{", self);
+        for(size_t i = 0; i < members.size(); ++i) {
+            println(ss, "        {0} {1} == other.{1}{2}", i ? "    &&" : "return", members[i]->name, i + 1 == members.size() ? ";" : "");
+        }
+        println(ss, "    }}");
+    }
+    if(ordering.empty()) return ss.str();
+    if(!indexed && !isRecursive) {
+        println(ss, "    {} operator<=>(const {}&) const = default;", ordering, self);
+        return ss.str();
+    }
+
+    println(ss, "    {} operator<=>(const {}& other) const {{", ordering, self);
+    for(size_t i = 0; i + 1 < members.size(); ++i) {
+        println(ss, "        if(auto order = {0} <=> other.{0}; order != 0) return order;", members[i]->name);
+    }
+    println(ss, "        return {0} <=> other.{0};", members.back()->name);
+    println(ss, "    }}");
+    return ss.str();
+}
+
+// Хеш структур для unordered-контейнеров (Types.h, после пространства имён схемы):
+// std::hash сворачивает поля через hashValue из Hash.cpp
+string Parser::hashSpecializations(const string& namespaceName) const {
+    std::stringstream ss;
+    const string scope = namespaceName.empty() ? "" : namespaceName + "::";
+    println(ss, "// Хеш структур согласован с operator==: равные значения имеют равные хеши");
+    for(const auto& complexType: complexTypes) {
+        println(ss, "template <>");
+        println(ss, "struct std::hash<{}{}> {{", scope, complexType.name);
+        println(ss, "    std::size_t operator()(const {0}{1}& value) const noexcept {{ return {0}hashValue(value); }}", scope, complexType.name);
+        println(ss, "}};\n");
+    }
+    return ss.str();
+}
+
+} // namespace Xsd
@@ -0,0 +1,143 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+#include <sstream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Описание полей и обход структур (Descriptors.h)
+constexpr auto metaDeclaration = R"(namespace meta {
+
+// Категория C++ типа поля
+enum class Kind {
+    String,
+    Scalar,
+    Binary,
+    Enum,
+    Complex,
+};
+
+// Число вхождений: значение, std::optional или std::vector
+enum class Occurs {
+    Required,
+    Optional,
+    Repeated,
+};
+
+// Место поля в XML
+enum class Node {
+    Attribute,
+    Element,
+    Text,
+};
+
+// Описание поля: всё, кроме имени, - параметры шаблона,
+// поэтому обработчики выбирают ветку через if constexpr без проверок во время выполнения
+template <auto Member, Kind K, Occurs O, Node N>
+struct FieldDescriptor {
+    static constexpr auto member = Member;
+    static constexpr Kind kind = K;
+    static constexpr Occurs occurs = O;
+    static constexpr Node node = N;
+    const char* name; // Имя в XML
+};
+
+// Таблица полей структуры в порядке сериализации: name и кортеж fields
+template <class T>
+struct Descriptor;
+
+// Вызывает fn(descriptor, member) для каждого поля value
+template <class T, class F>
+constexpr void visit(T& value, F&& fn) {
+    std::apply([&](const auto&... field) { (fn(field, value.*field.member), ...); },
+        Descriptor<std::remove_const_t<T>>::fields);
+}
+
+// Есть ли у структуры содержимое кроме атрибутов
+template <class T>
+constexpr bool hasContent() {
+    return std::apply([](const auto&... field) {
+        return ((std::remove_cvref_t<decltype(field)>::node != Node::Attribute) || ...);
+    },
+        Descriptor<T>::fields);
+}
+
+)"sv;
+
+string kindName(Field::Kind kind) {
+    switch(kind) {
+    case Field::Kind::String: return "String";
+    case Field::Kind::Scalar: return "Scalar";
+    case Field::Kind::Binary: return "Binary";
+    case Field::Kind::Enum: return "Enum";
+    case Field::Kind::Complex: return "Complex";
+    }
+    return "";
+}
+
+} // namespace
+
+string ComplexType::generateDescriptor(const string& namespaceName) const {
+    std::stringstream ss;
+
+    // Имена структур квалифицируются: meta::FieldDescriptor и поля могут совпадать с ними по имени
+    const string type = (namespaceName.empty() ? "::" : "::" + namespaceName + "::") + name;
+
+    println(ss, "template <>");
+    println(ss, "struct Descriptor<{}> {{", type);
+    println(ss, "    static constexpr const char* name = \"{}\";", name);
+    if(fields.empty()) {
+        println(ss, "    static constexpr std::tuple<> fields{{}};");
+        println(ss, "}};\n");
+        return ss.str();
+    }
+    println(ss, "    static constexpr std::tuple fields{{");
+    for(const auto& field: fields) {
+        const string_view occurs = field.isRepeated() ? "Repeated" : field.isOptional ? "Optional" : "Required";
+        const string_view node = field.isText ? "Text" : field.isAttribute ? "Attribute" : "Element";
+        println(ss, "        FieldDescriptor<&{}::{}, Kind::{}, Occurs::{}, Node::{}>{{\"{}\"}},",
+            type, field.name, kindName(field.kind), occurs, node, field.isText ? "" : field.xmlName);
+    }
+    println(ss, "    }};");
+    println(ss, "}};\n");
+
+    return ss.str();
+}
+
+bool Parser::generateDescriptors(const string& outputDir, const string& namespaceName) const {
+    std::ofstream header(outputDir + "/Descriptors.h");
+    if(!header.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Descriptors.h", outputDir);
+        return false;
+    }
+
+    println(header, "#pragma once\n");
+    println(header, "#include <tuple>");
+    println(header, "#include <type_traits>");
+    println(header, "#include \"Types.h\"\n");
+
+    if(!namespaceName.empty()) {
+        println(header, "namespace {} {{\n", namespaceName);
+    }
+
+    header << metaDeclaration;
+
+    for(const auto& complexType: complexTypes) {
+        header << complexType.generateDescriptor(namespaceName);
+    }
+
+    println(header, "}} // namespace meta");
+
+    if(!namespaceName.empty()) {
+        println(header, "\n}} // namespace {}", namespaceName);
+    }
+
+    header.close();
+    return true;
+}
+
+} // namespace Xsd
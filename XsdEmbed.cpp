@@ -0,0 +1,334 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+#include <sstream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Запись значений выражениями C++ (Embed.cpp)
+constexpr auto writerDeclaration = R"(
+// Собирает выражения C++ для значений экземпляра. Коллекции становятся именованными
+// статическими массивами: массив определяется раньше значения, которое на него ссылается
+class LiteralWriter {
+public:
+    explicit LiteralWriter(std::string scope)
+        : scope_{std::move(scope)} { }
+
+    // Массив type[] из выражений literal(*this, item); пустая коллекция - {}
+    template <class R>
+    std::string array(std::string_view type, const R& items);
+
+    // Заголовок с массивами и значением root по имени name
+    void write(std::ostream& out, std::string_view source, std::string_view name, const std::string& root) const;
+
+private:
+    std::string scope_;
+    std::string definitions_;
+    std::size_t count_ = 0;
+};
+
+// Схема может не содержать полей таких типов
+[[maybe_unused]] std::string literal(LiteralWriter& out, std::string_view text);
+[[maybe_unused]] std::string literal(LiteralWriter& out, bool value);
+[[maybe_unused]] std::string literal(LiteralWriter& out, const std::vector<unsigned char>& bytes);
+)"sv;
+
+// Обобщённые выражения значений: целые, вещественные, необязательные значения
+constexpr auto writerTemplates = R"(
+template <class T>
+    requires std::is_integral_v<T>
+std::string literal(LiteralWriter&, T value) {
+    if constexpr(std::is_unsigned_v<T>) {
+        return std::to_string(value) + 'u';
+    } else {
+        // Наименьшее значение не записывается литералом: -N - это минус, применённый к N
+        if(value == std::numeric_limits<T>::min()) return '(' + std::to_string(value + 1) + " - 1" + ')';
+        return std::to_string(value);
+    }
+}
+
+template <class T>
+    requires std::is_floating_point_v<T>
+std::string literal(LiteralWriter&, T value) {
+    const std::string type = std::is_same_v<T, float> ? "float" : "double";
+    const std::string limits = "std::numeric_limits<" + type + ">::";
+    if(std::isnan(value)) return limits + "quiet_NaN(" + ')';
+    if(std::isinf(value)) return (value < 0 ? "-" : "") + limits + "infinity(" + ')';
+    // Кратчайшая запись, читающаяся обратно без потерь
+    char buffer[64];
+    std::string text{buffer, std::to_chars(buffer, buffer + sizeof buffer, value).ptr};
+    if(text.find_first_of(".e") == std::string::npos) text += ".0";
+    return std::is_same_v<T, float> ? text + 'f' : text;
+}
+
+template <class T>
+std::string literal(LiteralWriter& out, const std::optional<T>& value) {
+    return value ? literal(out, *value) : "std::nullopt";
+}
+
+template <class R>
+std::string LiteralWriter::array(std::string_view type, const R& items) {
+    std::string body;
+    for(const auto& item: items) body += "    " + literal(*this, item) + ",\n";
+    if(body.empty()) return "{}";
+    const std::string name = "a" + std::to_string(count_++);
+    definitions_ += "inline constexpr " + std::string{type} + ' ' + name + "[] = {\n" + body + "};\n";
+    return scope_ + "::" + name;
+}
+)"sv;
+
+// Разделяемые поддеревья записываются как обычные значения (Options::intern)
+constexpr auto sharedLiteral = R"(
+template <class T>
+std::string literal(LiteralWriter& out, const Shared<T>& value) {
+    return literal(out, value.get());
+}
+)"sv;
+
+constexpr auto writerDefinition = R"(
+// Строка как литерал: непечатаемые байты - восьмеричными escape-последовательностями,
+// которые в отличие от \x не поглощают следующие цифры
+std::string literal(LiteralWriter&, std::string_view text) {
+    std::string quoted = "\"";
+    for(const char c: text) {
+        switch(c) {
+        case '"': quoted += "\\\""; break;
+        case '\\': quoted += "\\\\"; break;
+        case '\n': quoted += "\\n"; break;
+        case '\t': quoted += "\\t"; break;
+        default:
+            if(static_cast<unsigned char>(c) < 0x20 || c == 0x7f) {
+                const auto code = static_cast<unsigned char>(c);
+                quoted += {'\\', char('0' + (code >> 6)), char('0' + ((code >> 3) & 7)), char('0' + (code & 7))};
+            } else {
+                quoted += c;
+            }
+        }
+    }
+    return quoted + '"';
+}
+
+std::string literal(LiteralWriter&, bool value) {
+    return value ? "true" : "false";
+}
+
+std::string literal(LiteralWriter& out, const std::vector<unsigned char>& bytes) {
+    return out.array("unsigned char", bytes);
+}
+
+void LiteralWriter::write(std::ostream& out, std::string_view source, std::string_view name, const std::string& root) const {
+    out << "#pragma once\n\n";
+    out << "// " << source << ", встроенный xsd_generated_embed: значение вычисляется при компиляции,\n";
+    out << "// строки и коллекции лежат в статических массивах\n\n";
+    out << "#include \"Literal.h\"\n\n";
+    if(!schemaNamespace.empty()) out << "namespace " << schemaNamespace << " {\n\n";
+    if(!definitions_.empty()) out << "namespace " << scope_ << " {\n\n" << definitions_ << "\n} // namespace " << scope_ << "\n\n";
+    out << "inline constexpr literal::" << rootType << ' ' << name << " = " << root << ";\n";
+    if(!schemaNamespace.empty()) out << "\n} // namespace " << schemaNamespace << '\n';
+}
+
+// Имя C++ из имени элемента: прочие символы заменяются на '_'
+std::string identifier(std::string_view text) {
+    std::string name;
+    for(const char c: text) name += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    if(name.empty() || std::isdigit(static_cast<unsigned char>(name.front()))) name.insert(name.begin(), '_');
+    return name;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if(argc < 3) {
+        std::fprintf(stderr, "Usage: %s instance.xml output.h [name]\n", argv[0]);
+        return 2;
+    }
+    const std::string name = identifier(argc > 3 ? argv[3] : rootTag);
+    try {
+        const auto document = loadDocument<Root>(argv[1], rootTag);
+        LiteralWriter writer{name + "_data"};
+        const std::string root = literal(writer, document.root);
+        std::ofstream header(argv[2]);
+        if(!header) throw std::runtime_error(std::string{"Failed to create "} + argv[2]);
+        writer.write(header, argv[1], name, root);
+    } catch(const std::exception& e) {
+        std::fprintf(stderr, "%s: %s\n", argv[1], e.what());
+        return 1;
+    }
+    return 0;
+}
+)"sv;
+
+// Тип поля в Literal.h: строки - std::string_view, коллекции и двоичные данные - std::span
+string literalType(const ComplexType& owner, const Field& field, const string& namespaceName) {
+    string type = field.type;
+    switch(field.kind) {
+    case Field::Kind::String: type = "std::string_view"; break;
+    case Field::Kind::Binary: type = "std::span<const unsigned char>"; break;
+    case Field::Kind::Complex:
+    case Field::Kind::Enum:
+        // Имя поля совпадает с именем типа - квалифицируем тип, как в Types.h
+        if(std::ranges::any_of(owner.fields, [&](const Field& other) { return other.name == field.type; })) {
+            const string scope = namespaceName.empty() ? "::" : "::" + namespaceName + "::";
+            type = scope + (field.kind == Field::Kind::Complex ? "literal::" : "") + type;
+        }
+        break;
+    default: break;
+    }
+    if(field.isRepeated()) return "std::span<const " + type + ">";
+    if(field.isOptional) return "std::optional<" + type + ">";
+    return type;
+}
+
+// Тип элемента массива коллекции в заголовке экземпляра (пространство имён схемы)
+string elementType(const Field& field) {
+    switch(field.kind) {
+    case Field::Kind::String: return "std::string_view";
+    case Field::Kind::Binary: return "std::span<const unsigned char>";
+    case Field::Kind::Complex: return "literal::" + field.type;
+    default: return field.type;
+    }
+}
+
+} // namespace
+
+// Типы значений, пригодных для constexpr (Literal.h, Options::embed)
+string ComplexType::generateLiteralDecl(const string& namespaceName) const {
+    std::stringstream ss;
+    println(ss, "struct {} {{", name);
+    for(const auto& field: fields) {
+        println(ss, "    {} {};", literalType(*this, field, namespaceName), field.name);
+    }
+    println(ss, "}};\n");
+    return ss.str();
+}
+
+// Выражение значения структуры с назначенными инициализаторами в порядке полей Literal.h
+string ComplexType::generateLiteralCode() const {
+    std::stringstream ss;
+    println(ss, "std::string literal(LiteralWriter&{}, const {}&{}) {{", fields.empty() ? "" : " out", name, fields.empty() ? "" : " value");
+    println(ss, "    std::string text = \"literal::{}{{\";", name);
+    for(size_t i = 0; i < fields.size(); ++i) {
+        const Field& field = fields[i];
+        const string separator = i + 1 == fields.size() ? "" : ", ";
+        if(field.isRepeated()) {
+            println(ss, "    text += \".{0} = \" + out.array(\"{1}\", value.{0}) + \"{2}\";", field.name, elementType(field), separator);
+        } else {
+            println(ss, "    text += \".{0} = \" + literal(out, value.{0}) + \"{1}\";", field.name, separator);
+        }
+    }
+    println(ss, "    return text + '}}';");
+    println(ss, "}}\n");
+    return ss.str();
+}
+
+// Перечисление как имя перечислителя
+string Enum::generateLiteralCode() const {
+    std::stringstream ss;
+    println(ss, "std::string literal(LiteralWriter&, {} value) {{", name);
+    if(!values.empty()) {
+        println(ss, "    switch(value) {{");
+        for(const auto& value: values) {
+            println(ss, "    case {0}::{1}: return \"{0}::{1}\";", name, normalize(value));
+        }
+        println(ss, "    }}");
+    }
+    println(ss, "    return \"static_cast<{}>(\" + std::to_string(static_cast<long long>(value)) + ')';", name);
+    println(ss, "}}\n");
+    return ss.str();
+}
+
+// Встраивание экземпляров в программу (Options::embed): Literal.h с типами значений
+// и программа xsd_generated_embed, записывающая загруженный экземпляр constexpr-заголовком
+bool Parser::generateEmbed(const string& outputDir, const string& namespaceName) const {
+    const Element* root = rootElement();
+    if(!root) {
+        println(std::cout, "  Предупреждение: нет глобального элемента со структурой, Embed.cpp не создаётся");
+        return true;
+    }
+
+    std::ofstream header(outputDir + "/Literal.h");
+    if(!header.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Literal.h", outputDir);
+        return false;
+    }
+
+    println(header, "#pragma once\n");
+    println(header, "#include <cstdint>");
+    println(header, "#include <limits>");
+    println(header, "#include <optional>");
+    println(header, "#include <span>");
+    println(header, "#include <string_view>");
+    println(header, "#include \"Enums.h\"\n");
+    if(!namespaceName.empty()) {
+        println(header, "namespace {} {{\n", namespaceName);
+    }
+    println(header, "// Значения типов схемы, вычисляемые при компиляции (заголовки xsd_generated_embed):");
+    println(header, "// строки - std::string_view, коллекции и двоичные данные - std::span на статические массивы");
+    println(header, "namespace literal {{\n");
+    for(const auto& complexType: complexTypes) {
+        header << complexType.generateLiteralDecl(namespaceName);
+    }
+    println(header, "}} // namespace literal");
+    if(!namespaceName.empty()) {
+        println(header, "\n}} // namespace {}", namespaceName);
+    }
+    header.close();
+
+    std::ofstream source(outputDir + "/Embed.cpp");
+    if(!source.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Embed.cpp", outputDir);
+        return false;
+    }
+
+    println(source, "// Встраивание экземпляра схемы в программу: документ загружается и записывается");
+    println(source, "// заголовком с constexpr-значением типов Literal.h - без разбора и выделения памяти при запуске.");
+    println(source, "// Использование: xsd_generated_embed файл.xml заголовок.h [имя]\n");
+    println(source, "#include \"Reader.h\"");
+    println(source, "#include <cctype>");
+    println(source, "#include <charconv>");
+    println(source, "#include <cmath>");
+    println(source, "#include <cstdio>");
+    println(source, "#include <fstream>");
+    println(source, "#include <limits>");
+    println(source, "#include <optional>");
+    println(source, "#include <ostream>");
+    println(source, "#include <string>");
+    println(source, "#include <string_view>");
+    println(source, "#include <type_traits>");
+    println(source, "#include <vector>\n");
+
+    println(source, "namespace {{\n");
+    if(!namespaceName.empty()) {
+        println(source, "using namespace {};\n", namespaceName);
+    }
+    const string rootType = convertXsdTypeToCpp(root->type);
+    println(source, "using Root = {}::{};", namespaceName.empty() ? "" : "::" + namespaceName, rootType);
+    println(source, "constexpr std::string_view rootTag = \"{}\";", root->xmlName);
+    println(source, "constexpr std::string_view rootType = \"{}\";", rootType);
+    println(source, "constexpr std::string_view schemaNamespace = \"{}\";", namespaceName);
+
+    source << writerDeclaration;
+    for(const auto& enumType: enums) {
+        println(source, "std::string literal(LiteralWriter& out, {} value);", enumType.name);
+    }
+    for(const auto& complexType: complexTypes) {
+        println(source, "std::string literal(LiteralWriter& out, const {}& value);", complexType.name);
+    }
+    if(options_.intern) source << sharedLiteral;
+    source << writerTemplates;
+    println(source);
+    for(const auto& enumType: enums) {
+        source << enumType.generateLiteralCode();
+    }
+    for(const auto& complexType: complexTypes) {
+        source << complexType.generateLiteralCode();
+    }
+    source << writerDefinition;
+    return true;
+}
+
+} // namespace Xsd
@@ -0,0 +1,382 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+#include <sstream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Ошибки и разбор значений без исключений (Expected.h)
+constexpr auto errorDeclaration = R"(// Неверное значение: без выделения памяти, путь к узлу добавляет загрузчик
+enum class ValueError : std::uint8_t {
+    Invalid,    // Не разбирается как значение типа
+    OutOfRange, // Не помещается в тип поля
+};
+
+// Ошибка загрузки документа
+struct LoadError {
+    enum class Kind : std::uint8_t {
+        File,       // Файл не открывается или не читается
+        Syntax,     // Неверный XML
+        Root,       // Корневой элемент не tag
+        Missing,    // Нет обязательного атрибута или элемента
+        Invalid,    // Значение не разбирается
+        OutOfRange, // Значение не помещается в тип поля
+        Identity,   // Нарушено ограничение xs:key/xs:unique/xs:keyref
+    };
+
+    Kind kind{Kind::Invalid};
+    std::string path;   // Путь от корня: /device/peripherals/peripheral[3]/@name; номера одноимённых соседей - с 1
+    int line{0};        // Строка документа; 0 - неизвестна
+    std::string detail; // Неверное значение или описание ошибки
+
+    // "path (line N): описание"
+    std::string message() const;
+};
+
+template <class T>
+using Expected = std::expected<T, LoadError>;
+using Status = std::expected<void, LoadError>;
+
+template <Enum E>
+std::expected<E, ValueError> tryStringTo(std::string_view text);
+
+// Целые числа в записи parseInteger
+std::expected<ParsedInteger, ValueError> tryParseInteger(std::string_view text);
+std::expected<std::vector<unsigned char>, ValueError> tryParseHex(std::string_view text);
+
+// Значение типа T из текста узла
+template <class T>
+std::expected<T, ValueError> tryParse(std::string_view text) {
+    if constexpr(std::is_same_v<T, bool>) {
+        if(text == "true" || text == "1") return true;
+        if(text == "false" || text == "0") return false;
+        return std::unexpected{ValueError::Invalid};
+    } else if constexpr(std::is_integral_v<T>) {
+        const auto number = tryParseInteger(text);
+        if(!number) return std::unexpected{number.error()};
+        T value;
+        if(!narrowInteger(*number, value)) return std::unexpected{ValueError::OutOfRange};
+        return value;
+    } else if constexpr(std::is_floating_point_v<T>) {
+        while(!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+        if(!text.empty() && text.front() == '+') text.remove_prefix(1);
+        T value{};
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if(ec == std::errc::result_out_of_range) return std::unexpected{ValueError::OutOfRange};
+        if(ec != std::errc{}) return std::unexpected{ValueError::Invalid};
+        return value;
+    } else if constexpr(std::is_enum_v<T>) {
+        return tryStringTo<T>(text);
+    } else if constexpr(std::is_same_v<T, std::vector<unsigned char>>) {
+        return tryParseHex(text);
+    } else if constexpr(requires(T value, std::string_view view) { { value.assign(view) } -> std::same_as<bool>; }) {
+        // Строка фиксированной ёмкости
+        T value;
+        if(!value.assign(text)) return std::unexpected{ValueError::OutOfRange};
+        return value;
+    } else {
+        return T{text};
+    }
+}
+)"sv;
+
+// Разделяемые поддеревья (Options::intern)
+constexpr auto sharedReader = R"(
+template <class T>
+Status tryReadXml(const tinyxml2::XMLElement* element, Shared<T>& value) {
+    T item;
+    if(auto status = tryReadXml(element, item); !status) return status;
+    value = currentInterner ? currentInterner->intern(std::move(item)) : Shared<T>{std::move(item)};
+    return {};
+}
+)"sv;
+
+constexpr auto documentReaders = R"(
+LoadError documentError(const tinyxml2::XMLDocument& doc, std::string_view source);
+LoadError rootError(const tinyxml2::XMLElement* root, std::string_view tag);
+
+// Загружает корневой элемент tag из разобранного документа
+template <class T>
+Expected<T> tryReadDocument(const tinyxml2::XMLDocument& doc, std::string_view tag) {
+    const tinyxml2::XMLElement* root = doc.RootElement();
+    if(!root || tag != root->Name()) return std::unexpected{rootError(root, tag)};
+    Expected<T> value{std::in_place};
+    if(auto status = tryReadXml(root, *value); !status) return std::unexpected{std::move(status).error()};
+    return value;
+}
+
+// Загружает документ из файла
+template <class T>
+Expected<T> tryLoadXml(const std::string& path, std::string_view tag) {
+    tinyxml2::XMLDocument doc;
+    if(doc.LoadFile(path.c_str()) != tinyxml2::XML_SUCCESS) return std::unexpected{documentError(doc, path)};
+    return tryReadDocument<T>(doc, tag);
+}
+
+// Загружает документ из строки
+template <class T>
+Expected<T> tryParseXml(std::string_view xml, std::string_view tag) {
+    tinyxml2::XMLDocument doc;
+    if(doc.Parse(xml.data(), xml.size()) != tinyxml2::XML_SUCCESS) return std::unexpected{documentError(doc, "XML")};
+    return tryReadDocument<T>(doc, tag);
+}
+)"sv;
+
+// Определения: разбор значений и построение ошибок (Expected.cpp)
+constexpr auto errorDefinition = R"(std::string LoadError::message() const {
+    static constexpr const char* descriptions[]{
+        "cannot read file", "invalid XML", "unexpected root element", "missing required node",
+        "invalid value", "value out of range", "identity constraint violated"};
+    std::string text = path.empty() ? "document" : path;
+    if(line > 0) text += " (line " + std::to_string(line) + ')';
+    text += ": ";
+    text += descriptions[static_cast<std::size_t>(kind)];
+    if(!detail.empty()) text += kind == Kind::Invalid || kind == Kind::OutOfRange ? " '" + detail + "'" : ": " + detail;
+    return text;
+}
+
+std::expected<ParsedInteger, ValueError> tryParseInteger(std::string_view text) {
+    while(!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+    while(!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) text.remove_suffix(1);
+
+    bool negative = false;
+    if(!text.empty() && (text.front() == '+' || text.front() == '-')) {
+        negative = text.front() == '-';
+        text.remove_prefix(1);
+    }
+
+    int base = 10;
+    if(text.starts_with("0x") || text.starts_with("0X")) {
+        base = 16, text.remove_prefix(2);
+    } else if(text.starts_with("0b")) {
+        base = 2, text.remove_prefix(2);
+    } else if(text.starts_with("#")) {
+        base = 2, text.remove_prefix(1);
+    }
+
+    std::uint64_t scale = 1;
+    if(!text.empty() && base != 16) {
+        switch(text.back()) {
+        case 'k': case 'K': scale = 1ull << 10; break;
+        case 'm': case 'M': scale = 1ull << 20; break;
+        case 'g': case 'G': scale = 1ull << 30; break;
+        case 't': case 'T': scale = 1ull << 40; break;
+        default: break;
+        }
+        if(scale != 1) text.remove_suffix(1);
+    }
+
+    std::uint64_t value = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value, base);
+    if(ec == std::errc::result_out_of_range || value > std::numeric_limits<std::uint64_t>::max() / scale)
+        return std::unexpected{ValueError::OutOfRange};
+    if(text.empty() || ec != std::errc{} || end != text.data() + text.size()) return std::unexpected{ValueError::Invalid};
+    return ParsedInteger{value * scale, negative, base != 10};
+}
+
+std::expected<std::vector<unsigned char>, ValueError> tryParseHex(std::string_view text) {
+    if(text.size() % 2) return std::unexpected{ValueError::Invalid};
+    std::vector<unsigned char> value(text.size() / 2);
+    for(std::size_t i = 0; i < value.size(); ++i) {
+        auto [end, ec] = std::from_chars(text.data() + 2 * i, text.data() + 2 * i + 2, value[i], 16);
+        if(ec != std::errc{} || end != text.data() + 2 * i + 2) return std::unexpected{ValueError::Invalid};
+    }
+    return value;
+}
+
+LoadError documentError(const tinyxml2::XMLDocument& doc, std::string_view source) {
+    const bool file = doc.ErrorID() == tinyxml2::XML_ERROR_FILE_NOT_FOUND
+        || doc.ErrorID() == tinyxml2::XML_ERROR_FILE_COULD_NOT_BE_OPENED
+        || doc.ErrorID() == tinyxml2::XML_ERROR_FILE_READ_ERROR;
+    return {file ? LoadError::Kind::File : LoadError::Kind::Syntax, std::string{source}, doc.ErrorLineNum(), doc.ErrorStr()};
+}
+
+LoadError rootError(const tinyxml2::XMLElement* root, std::string_view tag) {
+    return {LoadError::Kind::Root, root ? "/" + std::string{root->Name()} : "", root ? root->GetLineNum() : 0,
+        "expected <" + std::string{tag} + ">"};
+}
+
+namespace {
+
+// Путь элемента от корня документа; строится только для ошибки
+std::string pathOf(const tinyxml2::XMLElement* element) {
+    std::string path;
+    for(; element; element = element->Parent() ? element->Parent()->ToElement() : nullptr) {
+        std::string step = "/" + std::string{element->Name()};
+        // Номер среди одноимённых соседей, если они есть
+        int index = 1;
+        for(auto* sibling = element->PreviousSiblingElement(element->Name()); sibling; sibling = sibling->PreviousSiblingElement(element->Name()))
+            ++index;
+        if(index > 1 || element->NextSiblingElement(element->Name())) step += "[" + std::to_string(index) + "]";
+        path.insert(0, step);
+    }
+    return path;
+}
+
+// Ошибка в узле node элемента element: "@имя", имя дочернего элемента или пусто - сам элемент
+std::unexpected<LoadError> fail(LoadError::Kind kind, const tinyxml2::XMLElement* element, std::string_view node, std::string detail) {
+    std::string path = pathOf(element);
+    if(!node.empty()) path += "/" + std::string{node};
+    return std::unexpected<LoadError>{std::in_place, kind, std::move(path), element->GetLineNum(), std::move(detail)};
+}
+
+std::unexpected<LoadError> missing(const tinyxml2::XMLElement* element, std::string_view node) {
+    return fail(LoadError::Kind::Missing, element, node, {});
+}
+
+// Разбирает text в target; ошибка указывает на узел node элемента element
+template <class T>
+Status readText(const tinyxml2::XMLElement* element, std::string_view node, const char* text, T& target) {
+    auto parsed = tryParse<T>(text ? text : "");
+    if(!parsed) {
+        const auto kind = parsed.error() == ValueError::OutOfRange ? LoadError::Kind::OutOfRange : LoadError::Kind::Invalid;
+        return fail(kind, element, node, text ? text : "");
+    }
+    target = std::move(*parsed);
+    return {};
+}
+
+} // namespace
+)"sv;
+
+} // namespace
+
+string ComplexType::generateExpectedDecl() const {
+    return std::format("Status tryReadXml(const tinyxml2::XMLElement* element, {}& value);\n", name);
+}
+
+// Загрузка без исключений: первая ошибка возвращается с путём к узлу.
+// Ленивые и параллельные коллекции декодируются сразу в текущем потоке
+string ComplexType::generateExpectedCode() const {
+    std::stringstream ss;
+
+    if(fields.empty() && constraints.empty()) {
+        println(ss, "Status tryReadXml(const tinyxml2::XMLElement*, {}&) {{ return {{}}; }}\n", name);
+        return ss.str();
+    }
+
+    println(ss, "Status tryReadXml(const tinyxml2::XMLElement* element, {}& value) {{", name);
+
+    for(const auto& field: fields) {
+        const string target = field.isRepeated()
+            ? std::format("value.{}.emplace_back()", field.name)
+            : field.isOptional
+            ? std::format("value.{}.emplace()", field.name)
+            : std::format("value.{}", field.name);
+
+        if(field.isText) {
+            println(ss, "    if(auto status = readText(element, \"text()\", element->GetText(), {}); !status) return status;", target);
+            continue;
+        }
+
+        if(field.isAttribute) {
+            println(ss, "    if(const char* text = element->Attribute(\"{}\")) {{", field.xmlName);
+            println(ss, "        if(auto status = readText(element, \"@{}\", text, {}); !status) return status;", field.xmlName, target);
+            println(ss, "    }}{}", field.isOptional ? "" : std::format(" else return missing(element, \"@{}\");", field.xmlName));
+            continue;
+        }
+
+        const string read = field.kind == Field::Kind::Complex
+            ? std::format("tryReadXml(child, {})", target)
+            : std::format("readText(child, {{}}, child->GetText(), {})", target);
+
+        if(field.isRepeated()) {
+            println(ss, "    for(auto* child = element->FirstChildElement(\"{0}\"); child; child = child->NextSiblingElement(\"{0}\"))", field.xmlName);
+            println(ss, "        if(auto status = {}; !status) return status;", read);
+        } else {
+            println(ss, "    if(auto* child = element->FirstChildElement(\"{}\")) {{", field.xmlName);
+            println(ss, "        if(auto status = {}; !status) return status;", read);
+            println(ss, "    }}{}", field.isOptional ? "" : std::format(" else return missing(element, \"{}\");", field.xmlName));
+        }
+    }
+
+    if(!constraints.empty()) {
+        println(ss, "    if(auto error = value.tryRebuildIndexes(); !error.empty())");
+        println(ss, "        return fail(LoadError::Kind::Identity, element, {{}}, std::move(error));");
+    }
+
+    println(ss, "    return {{}};");
+    println(ss, "}}\n");
+
+    return ss.str();
+}
+
+// Загрузчики и преобразования без исключений (Options::expected)
+bool Parser::generateExpected(const string& outputDir, const string& namespaceName) const {
+    std::ofstream header(outputDir + "/Expected.h");
+    if(!header.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Expected.h", outputDir);
+        return false;
+    }
+
+    println(header, "#pragma once\n");
+    println(header, "#include <cctype>");
+    println(header, "#include <charconv>");
+    println(header, "#include <concepts>");
+    println(header, "#include <cstdint>");
+    println(header, "#include <expected>");
+    println(header, "#include <limits>");
+    println(header, "#include <string>");
+    println(header, "#include <string_view>");
+    println(header, "#include <type_traits>");
+    println(header, "#include <vector>");
+    println(header, "#include \"Reader.h\"\n");
+
+    if(!namespaceName.empty()) {
+        println(header, "namespace {} {{\n", namespaceName);
+    }
+
+    header << errorDeclaration << '\n';
+    for(const auto& enumType: enums) {
+        if(!enumType.values.empty()) {
+            println(header, "template <> std::expected<{0}, ValueError> tryStringTo<{0}>(std::string_view text);", enumType.name);
+        }
+    }
+    println(header);
+
+    for(const auto& complexType: complexTypes) {
+        header << complexType.generateExpectedDecl();
+    }
+    if(options_.intern) {
+        header << sharedReader;
+    }
+    header << documentReaders;
+
+    if(!namespaceName.empty()) {
+        println(header, "\n}} // namespace {}", namespaceName);
+    }
+    header.close();
+
+    std::ofstream source(outputDir + "/Expected.cpp");
+    if(!source.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Expected.cpp", outputDir);
+        return false;
+    }
+
+    println(source, "#include \"Expected.h\"");
+    println(source, "#include <algorithm>");
+    println(source, "#include <iterator>");
+    println(source, "#include <utility>\n");
+    if(!namespaceName.empty()) {
+        println(source, "namespace {} {{\n", namespaceName);
+    }
+
+    source << errorDefinition << '\n';
+    for(const auto& enumType: enums) {
+        source << enumType.generateTryConversion();
+    }
+    for(const auto& complexType: complexTypes) {
+        source << complexType.generateExpectedCode();
+    }
+
+    if(!namespaceName.empty()) {
+        println(source, "}} // namespace {}", namespaceName);
+    }
+    return true;
+}
+
+} // namespace Xsd
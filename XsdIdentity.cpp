@@ -0,0 +1,331 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+#include <sstream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Имя типа, квалифицированное пространством имён: внутри структуры
+// имя типа может совпадать с именем поля
+string qualify(const string& type, const string& namespaceName) {
+    return (namespaceName.empty() ? "::" : "::" + namespaceName + "::") + type;
+}
+
+// Убирает префикс пространства имён (xs:name -> name)
+string_view localName(string_view name) {
+    auto colon = name.find(':');
+    return colon == string_view::npos ? name : name.substr(colon + 1);
+}
+
+string constraintKind(IdentityConstraint::Kind kind) {
+    switch(kind) {
+    case IdentityConstraint::Kind::Key: return "xs:key";
+    case IdentityConstraint::Kind::Unique: return "xs:unique";
+    case IdentityConstraint::Kind::KeyRef: return "xs:keyref";
+    }
+    return "";
+}
+
+// Тип коллекции, на которую указывает selector
+string collectionType(const IdentityConstraint& constraint, const string& namespaceName, const Options& options) {
+    const Field& items = constraint.path.back();
+    return (options.isLazy(items) ? "Lazy<" : "std::vector<") + qualify(items.type, namespaceName) + ">";
+}
+
+// Тип ключа в индексе и тип параметра find_by_*
+string keyType(const Field& key, const string& namespaceName) {
+    return key.kind == Field::Kind::Enum ? qualify(key.type, namespaceName) : key.type;
+}
+
+string keyParameter(const Field& key, const string& namespaceName) {
+    return key.kind == Field::Kind::String ? "std::string_view" : keyType(key, namespaceName);
+}
+
+string indexType(const Field& key, const string& namespaceName) {
+    if(key.kind == Field::Kind::String)
+        return "std::unordered_map<std::string, std::size_t, KeyHash, std::equal_to<>>";
+    return std::format("std::unordered_map<{}, std::size_t>", keyType(key, namespaceName));
+}
+
+const IdentityConstraint* findConstraint(const ComplexType& owner, const string& name) {
+    auto it = std::ranges::find_if(owner.constraints, [&](const IdentityConstraint& constraint) {
+        return constraint.name == name && constraint.kind != IdentityConstraint::Kind::KeyRef;
+    });
+    return it == owner.constraints.end() ? nullptr : &*it;
+}
+
+} // namespace
+
+void Parser::parseIdentityConstraints(const tinyxml2::XMLElement* element, const string& ownerType) {
+    using Kind = IdentityConstraint::Kind;
+    for(auto* child = element->FirstChildElement(); child; child = child->NextSiblingElement()) {
+        const string_view tag = localName(child->Name());
+        IdentityConstraint constraint;
+        if(tag == "key") constraint.kind = Kind::Key;
+        else if(tag == "unique") constraint.kind = Kind::Unique;
+        else if(tag == "keyref") constraint.kind = Kind::KeyRef;
+        else continue;
+
+        const char* name = child->Attribute("name");
+        const tinyxml2::XMLElement* selector = child->FirstChildElement("xs:selector");
+        if(!selector) selector = child->FirstChildElement("selector");
+        const tinyxml2::XMLElement* field = child->FirstChildElement("xs:field");
+        if(!field) field = child->FirstChildElement("field");
+        if(!name || !selector || !selector->Attribute("xpath") || !field || !field->Attribute("xpath")) {
+            println(std::cerr, "  Ошибка: {} без имени, selector или field", constraintKind(constraint.kind));
+            continue;
+        }
+
+        // Составные ключи (несколько xs:field) не поддерживаются
+        if(field->NextSiblingElement(field->Name())) {
+            println(std::cout, "  Предупреждение: составной ключ '{}' не поддерживается, пропускаем", name);
+            continue;
+        }
+
+        constraint.name = name;
+        std::ranges::replace(constraint.name, '-', '_');
+        std::ranges::replace(constraint.name, '.', '_');
+        constraint.selector = selector->Attribute("xpath");
+        constraint.field = field->Attribute("xpath");
+        if(const char* refer = child->Attribute("refer")) {
+            constraint.refer = localName(refer);
+        }
+
+        identityConstraints.emplace_back(ownerType, std::move(constraint));
+    }
+}
+
+// Сопоставляет XPath ограничений полям сгенерированных структур.
+// Поддерживаются selector вида "a/b/c" (промежуточные шаги - одиночные элементы,
+// последний - повторяющийся) и field вида "@attr", "child" или ".".
+void Parser::resolveIdentityConstraints() {
+    auto findType = [this](const string& name) -> ComplexType* {
+        auto it = std::ranges::find(complexTypes, name, &ComplexType::name);
+        return it == complexTypes.end() ? nullptr : &*it;
+    };
+    auto warn = [](const IdentityConstraint& constraint, string_view reason) {
+        println(std::cout, "  Предупреждение: {} '{}' пропущено: {}", constraintKind(constraint.kind), constraint.name, reason);
+    };
+
+    // Сначала ключи, затем ссылки на них
+    std::ranges::stable_partition(identityConstraints, [](const auto& entry) {
+        return entry.second.kind != IdentityConstraint::Kind::KeyRef;
+    });
+
+    for(auto& [ownerType, constraint]: identityConstraints) {
+        ComplexType* owner = findType(ownerType);
+        if(!owner) {
+            warn(constraint, "владелец не является complexType");
+            continue;
+        }
+
+        // selector: цепочка дочерних элементов
+        string_view selector = constraint.selector;
+        if(selector.find_first_of("|*") != string_view::npos || selector.find("//") != string_view::npos) {
+            warn(constraint, "поддерживаются только пути из дочерних элементов");
+            continue;
+        }
+        while(selector.starts_with("./")) selector.remove_prefix(2);
+
+        const ComplexType* current = owner;
+        bool valid = true;
+        for(size_t begin = 0; valid && begin <= selector.size();) {
+            size_t end = std::min(selector.find('/', begin), selector.size());
+            const string_view step = localName(selector.substr(begin, end - begin));
+            begin = end + 1;
+
+            const Field* field = nullptr;
+            if(current) {
+                auto it = std::ranges::find_if(current->fields, [&](const Field& field) {
+                    return !field.isAttribute && !field.isText && field.xmlName == step;
+                });
+                if(it != current->fields.end() && it->kind == Field::Kind::Complex) field = &*it;
+            }
+            if(!field) {
+                warn(constraint, std::format("шаг '{}' не найден", step));
+                valid = false;
+                break;
+            }
+            constraint.path.push_back(*field);
+            current = findType(field->type);
+        }
+        if(!valid) continue;
+
+        const Field& items = constraint.path.back();
+        if(!items.isRepeated()
+            || std::any_of(constraint.path.begin(), constraint.path.end() - 1, [](const Field& step) { return step.isRepeated(); })) {
+            warn(constraint, "selector должен выбирать одну повторяющуюся коллекцию");
+            continue;
+        }
+
+        if(!current) {
+            warn(constraint, "элементы коллекции не являются complexType");
+            continue;
+        }
+
+        // field: атрибут, дочерний элемент или текст выбранного элемента
+        string_view fieldPath = constraint.field;
+        while(fieldPath.starts_with("./") && fieldPath.size() > 2) fieldPath.remove_prefix(2);
+        const bool attribute = fieldPath.starts_with('@');
+        const string_view keyName = localName(attribute ? fieldPath.substr(1) : fieldPath);
+        auto key = std::ranges::find_if(current->fields, [&](const Field& field) {
+            if(keyName == ".") return field.isText;
+            return field.isAttribute == attribute && !field.isText && field.xmlName == keyName;
+        });
+        if(key == current->fields.end() || key->isRepeated()
+            || key->kind == Field::Kind::Complex || key->kind == Field::Kind::Binary) {
+            warn(constraint, std::format("поле '{}' не является простым значением", constraint.field));
+            continue;
+        }
+        constraint.key = *key;
+
+        if(constraint.kind == IdentityConstraint::Kind::KeyRef) {
+            const IdentityConstraint* target = findConstraint(*owner, constraint.refer);
+            if(!target) {
+                warn(constraint, std::format("ключ '{}' не объявлен в том же элементе", constraint.refer));
+                continue;
+            }
+            if(target->key.type != constraint.key.type) {
+                warn(constraint, "тип ссылки не совпадает с типом ключа");
+                continue;
+            }
+        }
+
+        owner->constraints.push_back(constraint);
+    }
+    identityConstraints.clear();
+}
+
+string ComplexType::generateIndexDecl(const string& namespaceName, const Options& options) const {
+    std::stringstream ss;
+
+    for(const auto& constraint: constraints) {
+        const string itemType = qualify(constraint.path.back().type, namespaceName);
+        println(ss, "\n    // {} {}: {} по {}", constraintKind(constraint.kind), constraint.name, constraint.selector, constraint.field);
+        if(constraint.kind == IdentityConstraint::Kind::KeyRef) {
+            const IdentityConstraint& target = *findConstraint(*this, constraint.refer);
+            println(ss, "    // Позиции элементов {} для каждого элемента коллекции, npos - ссылки нет", target.name);
+            println(ss, "    std::vector<std::size_t> {}Targets;", constraint.name);
+            println(ss, "    const {}* resolve_{}(std::size_t index) const;", qualify(target.path.back().type, namespaceName), constraint.name);
+        } else {
+            println(ss, "    {} {}Index;", indexType(constraint.key, namespaceName), constraint.name);
+            println(ss, "    const {}* find_by_{}({} key) const;", itemType, constraint.name, keyParameter(constraint.key, namespaceName));
+        }
+        println(ss, "    const {}* {}Items() const;", collectionType(constraint, namespaceName, options), constraint.name);
+    }
+
+    println(ss, "\n    // Перестраивает индексы и разрешает ссылки после загрузки или изменения коллекций.");
+    println(ss, "    // Бросает std::runtime_error при повторе ключа или ссылке на несуществующий ключ.");
+    println(ss, "    void rebuildIndexes();");
+    if(options.expected) {
+        println(ss, "    // То же без исключений: описание первой ошибки, пусто - индексы построены");
+        println(ss, "    std::string tryRebuildIndexes();");
+    }
+
+    return ss.str();
+}
+
+string ComplexType::generateIndexCode(const string& namespaceName, const Options& options) const {
+    std::stringstream ss;
+
+    // В Types.h определения встраиваемые, в режиме leanHeaders они в Types.cpp
+    const string_view inlineSpec = options.leanHeaders ? "" : "inline ";
+
+    // Доступ к коллекциям: отсутствующий необязательный шаг даёт nullptr
+    for(const auto& constraint: constraints) {
+        println(ss, "{}const {}* {}::{}Items() const {{", inlineSpec, collectionType(constraint, namespaceName, options), name, constraint.name);
+        string parent;
+        for(size_t i = 0; i + 1 < constraint.path.size(); ++i) {
+            const Field& step = constraint.path[i];
+            if(step.isOptional) {
+                println(ss, "    if(!{}{}) return nullptr;", parent, step.name);
+                println(ss, "    const auto& step{} = *{}{};", i, parent, step.name);
+            } else {
+                println(ss, "    const auto& step{} = {}{};", i, parent, step.name);
+            }
+            parent = std::format("step{}.", i);
+        }
+        println(ss, "    return &{}{};", parent, constraint.path.back().name);
+        println(ss, "}}\n");
+    }
+
+    // Поиск по ключу и разрешённые ссылки
+    for(const auto& constraint: constraints) {
+        if(constraint.kind == IdentityConstraint::Kind::KeyRef) {
+            const IdentityConstraint& target = *findConstraint(*this, constraint.refer);
+            println(ss, "{}const {}* {}::resolve_{}(std::size_t index) const {{", inlineSpec, qualify(target.path.back().type, namespaceName), name, constraint.name);
+            println(ss, "    if(index >= {0}Targets.size() || {0}Targets[index] == static_cast<std::size_t>(-1)) return nullptr;", constraint.name);
+            println(ss, "    return &(*{}Items())[{}Targets[index]];", target.name, constraint.name);
+        } else {
+            println(ss, "{}const {}* {}::find_by_{}({} key) const {{", inlineSpec, qualify(constraint.path.back().type, namespaceName), name, constraint.name,
+                keyParameter(constraint.key, namespaceName));
+            println(ss, "    auto found = {}Index.find(key);", constraint.name);
+            println(ss, "    return found == {0}Index.end() ? nullptr : &(*{0}Items())[found->second];", constraint.name);
+        }
+        println(ss, "}}\n");
+    }
+
+    // Построение индексов за один проход по каждой коллекции, затем разрешение ссылок.
+    // Вариант tryRebuildIndexes (Options::expected) возвращает ошибку вместо исключения
+    for(const bool throwing: {true, false}) {
+        if(!throwing && !options.expected) break;
+        auto fail = [throwing](const string& message) {
+            return throwing ? std::format("throw std::runtime_error({});", message) : std::format("return {};", message);
+        };
+        if(throwing)
+            println(ss, "{}void {}::rebuildIndexes() {{", inlineSpec, name);
+        else
+            println(ss, "{}std::string {}::tryRebuildIndexes() {{", inlineSpec, name);
+        for(const auto& constraint: constraints) {
+            const bool isKeyRef = constraint.kind == IdentityConstraint::Kind::KeyRef;
+            const Field& key = constraint.key;
+            const string container = isKeyRef ? constraint.name + "Targets" : constraint.name + "Index";
+            const string value = key.isOptional ? "*item." + key.name : "item." + key.name;
+            // Строковый ключ добавляется в сообщение об ошибке
+            auto message = [&](string_view what) {
+                return key.kind == Field::Kind::String
+                    ? std::format("\"{}: \" + std::string{{{}}}", what, value)
+                    : std::format("\"{}\"", what);
+            };
+
+            println(ss, "    {}.clear();", container);
+            println(ss, "    if(const auto* items = {}Items()) {{", constraint.name);
+            println(ss, "        {}.reserve(items->size());", container);
+            println(ss, "        for(std::size_t i = 0; i < items->size(); ++i) {{");
+            println(ss, "            const auto& item = (*items)[i];");
+            if(isKeyRef) {
+                if(key.isOptional) {
+                    println(ss, "            if(!item.{}) {{", key.name);
+                    println(ss, "                {}.push_back(static_cast<std::size_t>(-1));", container);
+                    println(ss, "                continue;");
+                    println(ss, "            }}");
+                }
+                println(ss, "            auto found = {}Index.find({});", constraint.refer, value);
+                println(ss, "            if(found == {}Index.end())", constraint.refer);
+                println(ss, "                {}", fail(message("Unresolved xs:keyref " + constraint.name)));
+                println(ss, "            {}.push_back(found->second);", container);
+            } else {
+                if(key.isOptional) {
+                    if(constraint.kind == IdentityConstraint::Kind::Key)
+                        println(ss, "            if(!item.{}) {}", key.name, fail(std::format("\"Missing xs:key {}\"", constraint.name)));
+                    else
+                        println(ss, "            if(!item.{}) continue;", key.name);
+                }
+                println(ss, "            if(!{}.emplace({}, i).second)", container, value);
+                println(ss, "                {}", fail(message("Duplicate " + constraintKind(constraint.kind) + " " + constraint.name)));
+            }
+            println(ss, "        }}");
+            println(ss, "    }}");
+        }
+        if(!throwing) println(ss, "    return {{}};");
+        println(ss, "}}\n");
+    }
+
+    return ss.str();
+}
+
+} // namespace Xsd
@@ -0,0 +1,249 @@
+#include "XsdParser.h"
+#include <charconv>
+#include <format>
+#include <iostream>
+#include <set>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+constexpr int maxDepth = 32;            // Глубже необязательные элементы не создаются
+constexpr double collectionFanout = 8;  // Доля бюджета коллекции на один элемент - 1/8
+
+// Границы фасета как число; false - не задана или не числовая
+template <class T>
+bool bound(const string& text, T& value) {
+    if(text.empty()) return false;
+    const char* first = text.data() + (text.starts_with('+') ? 1 : 0);
+    auto [end, ec] = std::from_chars(first, text.data() + text.size(), value);
+    return ec == std::errc{} && end == text.data() + text.size();
+}
+
+// Потоковая запись документа с подсчётом объёма: в памяти только буфер
+class InstanceWriter {
+public:
+    explicit InstanceWriter(std::ofstream& file)
+        : file_{file} {
+        buffer_.reserve(capacity);
+    }
+    ~InstanceWriter() { flush(); }
+
+    void raw(string_view text) {
+        buffer_ += text;
+        written_ += text.size();
+        if(buffer_.size() >= capacity) flush();
+    }
+    void escaped(string_view text) {
+        for(char c: text) {
+            switch(c) {
+            case '&': raw("&amp;"); break;
+            case '<': raw("&lt;"); break;
+            case '>': raw("&gt;"); break;
+            case '"': raw("&quot;"); break;
+            default: raw({&c, 1});
+            }
+        }
+    }
+    void flush() {
+        file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+    uint64_t written() const { return written_; }
+
+private:
+    static constexpr size_t capacity = 1 << 16;
+    std::ofstream& file_;
+    string buffer_;
+    uint64_t written_{0};
+};
+
+// Обход IR: значения по типам и фасетам полей, число повторений - по бюджету размера
+class InstanceGenerator {
+public:
+    InstanceGenerator(const vector<ComplexType>& complexTypes, const vector<Enum>& enums, InstanceWriter& out, uint64_t seed)
+        : out_{out}
+        , random_{seed} {
+        for(const auto& complexType: complexTypes) types_.emplace(complexType.name, &complexType);
+        for(const auto& enumType: enums) enums_.emplace(enumType.name, &enumType);
+    }
+
+    void element(const ComplexType& type, string_view tag, double budget, int depth) {
+        out_.raw("<"), out_.raw(tag);
+        for(const auto& field: type.fields) {
+            if(!field.isAttribute || !present(field, depth)) continue;
+            out_.raw(" "), out_.raw(field.xmlName), out_.raw("=\"");
+            value(field);
+            out_.raw("\"");
+        }
+        out_.raw(">");
+
+        // Бюджет делится между вложенными структурами и неограниченными коллекциями:
+        // каждая получает равную долю остатка, так что недоиспользованное достаётся следующим
+        auto consumes = [this](const Field& field) { return !field.isAttribute && growable(field); };
+        const uint64_t start = out_.written();
+        auto consumers = std::ranges::count_if(type.fields, consumes);
+        for(const auto& field: type.fields) {
+            if(field.isAttribute) continue;
+            double share = 0;
+            if(consumes(field)) {
+                share = std::max(0.0, budget - static_cast<double>(out_.written() - start)) / static_cast<double>(consumers--);
+            }
+            if(field.isText) {
+                if(present(field, depth)) value(field);
+            } else if(field.isRepeated()) {
+                collection(field, share, depth);
+            } else if(present(field, depth)) {
+                child(field, share, depth);
+            }
+        }
+        out_.raw("</"), out_.raw(tag), out_.raw(">");
+    }
+
+private:
+    // Поле может расти с бюджетом: неограниченная коллекция или структура, содержащая такую
+    bool growable(const Field& field) {
+        if(field.maxOccurs == -1) return true;
+        if(field.kind != Field::Kind::Complex) return false;
+        auto it = types_.find(field.type);
+        if(it == types_.end()) return false;
+        if(auto known = growable_.find(field.type); known != growable_.end()) return known->second;
+        growable_[field.type] = false; // Рекурсивные типы растут только через коллекции
+        const bool result = std::ranges::any_of(it->second->fields, [this](const Field& member) { return growable(member); });
+        return growable_[field.type] = result;
+    }
+
+    // Необязательные поля присутствуют с вероятностью 1/2, глубже maxDepth - отсутствуют
+    bool present(const Field& field, int depth) {
+        if(!field.isOptional) return true;
+        return depth < maxDepth && std::bernoulli_distribution{0.5}(random_);
+    }
+
+    // Элементы коллекции добавляются, пока не исчерпана доля бюджета (не меньше minOccurs, не больше maxOccurs);
+    // каждому элементу достаётся 1/collectionFanout доли, поэтому размер распределяется по всем уровням
+    void collection(const Field& field, double share, int depth) {
+        const uint64_t start = out_.written();
+        const int minimum = depth < maxDepth ? field.minOccurs : std::min(field.minOccurs, 1);
+        for(int count = 0; field.maxOccurs == -1 || count < field.maxOccurs; ++count) {
+            const double used = static_cast<double>(out_.written() - start);
+            if(count >= minimum && (used >= share || depth >= maxDepth)) break;
+            child(field, share / collectionFanout, depth);
+        }
+    }
+
+    void child(const Field& field, double budget, int depth) {
+        const string& tag = field.xmlName.empty() ? field.name : field.xmlName;
+        if(field.kind == Field::Kind::Complex) {
+            if(auto it = types_.find(field.type); it != types_.end()) {
+                element(*it->second, tag, budget, depth + 1);
+                return;
+            }
+        }
+        out_.raw("<"), out_.raw(tag), out_.raw(">");
+        value(field);
+        out_.raw("</"), out_.raw(tag), out_.raw(">");
+    }
+
+    void value(const Field& field) {
+        switch(field.kind) {
+        case Field::Kind::Enum: {
+            auto it = enums_.find(field.type);
+            if(it != enums_.end() && !it->second->values.empty()) {
+                const auto& values = it->second->values;
+                out_.escaped(values[std::uniform_int_distribution<size_t>{0, values.size() - 1}(random_)]);
+            }
+            break;
+        }
+        case Field::Kind::Scalar: scalar(field); break;
+        case Field::Kind::Binary: {
+            const int size = field.facets.length >= 0 ? field.facets.length : std::uniform_int_distribution{1, 8}(random_);
+            for(int i = 0; i < size; ++i) out_.raw(std::format("{:02X}", std::uniform_int_distribution{0, 255}(random_)));
+            break;
+        }
+        default: {
+            auto text = strings_.sample(field.facets, random_);
+            if(!text) {
+                if(warned_.insert(field.type + "/" + field.name).second)
+                    println(std::cout, "  Предупреждение: не удалось подобрать значение поля {}", field.name);
+                text = "x";
+            }
+            out_.escaped(*text);
+        }
+        }
+    }
+
+    void scalar(const Field& field) {
+        const Facets& facets = field.facets;
+        if(field.type == "bool") {
+            out_.raw(std::bernoulli_distribution{0.5}(random_) ? "true" : "false");
+            return;
+        }
+        if(const IntegerType* integer = IntegerType::find(field.type)) {
+            int64_t low = integer->min;
+            int64_t high = integer->max > uint64_t{INT64_MAX} ? INT64_MAX : static_cast<int64_t>(integer->max);
+            int64_t value{};
+            if(bound(facets.minInclusive, value)) low = std::max(low, value);
+            if(bound(facets.minExclusive, value) && value < INT64_MAX) low = std::max(low, value + 1);
+            if(bound(facets.maxInclusive, value)) high = std::min(high, value);
+            if(bound(facets.maxExclusive, value) && value > INT64_MIN) high = std::min(high, value - 1);
+            // Значения выбираются около нуля, чтобы размер документа не зависел от разрядности
+            int64_t from = std::max<int64_t>(low, -32768);
+            int64_t to = std::min<int64_t>(high, 65535);
+            if(from > to) {
+                if(low > 65535) from = low, to = low + std::min<int64_t>(high - low, 65535);
+                else to = high, from = high - std::min<int64_t>(high - low, 65535);
+            }
+            out_.raw(std::to_string(std::uniform_int_distribution<int64_t>{from, to}(random_)));
+            return;
+        }
+        double low = 0, high = 1000, value{};
+        if(bound(facets.minInclusive, value) || bound(facets.minExclusive, value)) low = value;
+        if(bound(facets.maxInclusive, value) || bound(facets.maxExclusive, value)) high = value;
+        if(high < low) high = low;
+        // Три знака после запятой; исключающие границы не достигаются
+        const double number = std::uniform_real_distribution{low, high}(random_);
+        out_.raw(std::format("{:.3f}", std::clamp(number, low + (facets.minExclusive.empty() ? 0 : 1e-3),
+                                           high - (facets.maxExclusive.empty() ? 0 : 1e-3))));
+    }
+
+    InstanceWriter& out_;
+    std::mt19937_64 random_;
+    StringSampler strings_;
+    std::map<string, const ComplexType*> types_;
+    std::map<string, const Enum*> enums_;
+    std::map<string, bool> growable_;
+    std::set<string> warned_;
+};
+
+} // namespace
+
+// Синтетический экземпляр схемы размером около size байт для нагрузочных испытаний.
+// Документ пишется потоком, поэтому размер ограничен только диском; seed задаёт содержимое
+bool Parser::generateInstance(const string& path, uint64_t size, uint64_t seed) const {
+    const Element* root = rootElement();
+    if(!root) {
+        println(std::cerr, "Нет глобального элемента со структурой для экземпляра");
+        return false;
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if(!file.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}", path);
+        return false;
+    }
+
+    const string type = convertXsdTypeToCpp(root->type);
+    const auto it = std::ranges::find(complexTypes, type, &ComplexType::name);
+    {
+        InstanceWriter out{file};
+        out.raw("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+        InstanceGenerator{complexTypes, enums, out, seed}.element(*it, root->xmlName, static_cast<double>(size), 0);
+        out.raw("\n");
+        println(std::cout, "Экземпляр {}: {} байт", path, out.written());
+    }
+    return file.good();
+}
+
+} // namespace Xsd
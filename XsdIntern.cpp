@@ -0,0 +1,329 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+#include <sstream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Разделяемое поддерево (Types.h, Options::intern)
+constexpr auto sharedDeclaration = R"(// Неизменяемое поддерево с подсчётом ссылок. Одинаковые поддеревья, загруженные
+// через Interner (loadInterned), разделяют один узел. Структурный хеш вычисляется
+// при создании узла, поэтому хеш родителя не обходит поддерево повторно.
+// Пустой указатель читается как значение по умолчанию.
+template <class T>
+class Shared {
+public:
+    using element_type = T;
+
+    Shared() = default;
+    Shared(T value) {
+        const std::size_t hash = hashValue(value);
+        node_ = std::make_shared<const Node>(std::move(value), hash);
+    }
+
+    const T& get() const { return node_ ? node_->value : empty(); }
+    const T& operator*() const { return get(); }
+    const T* operator->() const { return &get(); }
+    operator const T&() const { return get(); }
+
+    std::size_t hash() const { return node_ ? node_->hash : hashValue(empty()); }
+    long useCount() const { return node_.use_count(); }
+
+    // Разделённые узлы равны по указателю; иначе сравнивается содержимое
+    friend bool operator==(const Shared& left, const Shared& right) {
+        return left.node_ == right.node_ || (left.hash() == right.hash() && equalValue(left.get(), right.get()));
+    }
+
+private:
+    friend class Interner;
+
+    struct Node {
+        Node(T value, std::size_t hash)
+            : value{std::move(value)}
+            , hash{hash} { }
+        T value;
+        std::size_t hash;
+    };
+
+    Shared(T value, std::size_t hash)
+        : node_{std::make_shared<const Node>(std::move(value), hash)} { }
+
+    static const T& empty() {
+        static const T value{};
+        return value;
+    }
+
+    std::shared_ptr<const Node> node_;
+};
+
+)"sv;
+
+// Пул поддеревьев и загрузка с разделением (Reader.h)
+constexpr auto internDeclaration = R"(
+// Пул поддеревьев: каждое загруженное поддерево ищется по структурному хешу среди уже
+// встреченных того же типа. Дочерние поддеревья читаются и разделяются раньше родителя,
+// поэтому сравнение кандидатов останавливается на совпадении указателей детей.
+// Пул можно уничтожить после загрузки: узлы живут, пока на них ссылается модель.
+class Interner {
+public:
+    template <class T>
+    Shared<T> intern(T&& value) {
+        const std::size_t hash = hashValue(value);
+        std::lock_guard lock{mutex_};
+        ++requests_;
+        auto& pool = poolOf<T>();
+        for(auto [it, end] = pool.equal_range(hash); it != end; ++it) {
+            if(equalValue(it->second.get(), value)) return it->second;
+        }
+        ++unique_;
+        return pool.emplace(hash, Shared<T>{std::move(value), hash})->second;
+    }
+
+    // Загружено поддеревьев всего и различных среди них
+    std::size_t requests() const { return requests_; }
+    std::size_t unique() const { return unique_; }
+
+private:
+    template <class T>
+    using Pool = std::unordered_multimap<std::size_t, Shared<T>>;
+
+    template <class T>
+    Pool<T>& poolOf() {
+        auto& pool = pools_[std::type_index{typeid(T)}];
+        if(!pool) pool = std::make_shared<Pool<T>>();
+        return *static_cast<Pool<T>*>(pool.get());
+    }
+
+    std::mutex mutex_;
+    std::unordered_map<std::type_index, std::shared_ptr<void>> pools_;
+    std::size_t requests_ = 0;
+    std::size_t unique_ = 0;
+};
+
+// Пул загрузки текущего потока; nullptr - поддеревья не разделяются.
+// Элементы, загружаемые пулом LoadPool или лениво, читаются без разделения
+inline thread_local Interner* currentInterner = nullptr;
+
+// Назначает пул загрузки текущего потока на время своей жизни
+class InternScope {
+public:
+    explicit InternScope(Interner& interner)
+        : previous_{currentInterner} {
+        currentInterner = &interner;
+    }
+    ~InternScope() { currentInterner = previous_; }
+    InternScope(const InternScope&) = delete;
+    InternScope& operator=(const InternScope&) = delete;
+
+private:
+    Interner* previous_;
+};
+
+template <class T>
+void readXml(const tinyxml2::XMLElement* element, Shared<T>& value) {
+    T item;
+    readXml(element, item);
+    value = currentInterner ? currentInterner->intern(std::move(item)) : Shared<T>{std::move(item)};
+}
+
+// Загружает документ, разделяя одинаковые поддеревья через interner
+template <class T>
+Record<T> loadInterned(const std::string& path, std::string_view tag, Interner& interner) {
+    InternScope scope{interner};
+    return loadRecord<T>(path, tag);
+}
+
+template <class T>
+Record<T> parseInterned(std::string_view xml, std::string_view tag, Interner& interner) {
+    InternScope scope{interner};
+    return readRecord<T>(xml, tag);
+}
+)"sv;
+
+// Обобщённые хеш и сравнение полей (Hash.cpp)
+constexpr auto hashHelpersBegin = R"(namespace {
+
+template <class T>
+struct IsShared : std::false_type { };
+)"sv;
+
+// Shared<T> есть только в режиме Options::intern
+constexpr auto isSharedSpecialization = R"(template <class T>
+struct IsShared<Shared<T>> : std::true_type { };
+)"sv;
+
+constexpr auto hashHelpersEnd = R"(
+template <class T>
+struct IsOptional : std::false_type { };
+template <class T>
+struct IsOptional<std::optional<T>> : std::true_type { };
+
+void combine(std::size_t& seed, std::size_t hash) {
+    seed ^= hash + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
+// Значения, равные тогда и только тогда, когда совпадают их байты: целые, перечисления,
+// FixedString и структуры из них без дополнения. Непрерывные коллекции таких значений
+// сравниваются memcmp и хешируются одним проходом, а не поэлементно
+template <class T>
+constexpr bool bytewise = std::has_unique_object_representations_v<T>;
+
+template <class R>
+concept BytewiseRange = std::ranges::contiguous_range<R> && bytewise<std::ranges::range_value_t<R>>;
+
+template <class R>
+std::string_view rangeBytes(const R& range) {
+    return {reinterpret_cast<const char*>(std::ranges::data(range)), std::ranges::size(range) * sizeof(std::ranges::range_value_t<R>)};
+}
+
+template <class T>
+std::string_view objectBytes(const T& value) {
+    return {reinterpret_cast<const char*>(&value), sizeof value};
+}
+
+template <class T>
+std::size_t hashOf(const T& value) {
+    if constexpr(IsShared<T>::value) {
+        return value.hash();
+    } else if constexpr(IsOptional<T>::value) {
+        return value ? hashOf(*value) + 1 : 0;
+    } else if constexpr(requires { hashValue(value); }) {
+        return hashValue(value);
+    } else if constexpr(std::is_convertible_v<const T&, std::string_view>) {
+        return std::hash<std::string_view>{}(value);
+    } else if constexpr(BytewiseRange<T>) {
+        return std::hash<std::string_view>{}(rangeBytes(value));
+    } else if constexpr(std::ranges::range<T>) {
+        std::size_t seed = 0;
+        for(const auto& item: value) combine(seed, hashOf(item));
+        return seed;
+    } else {
+        return std::hash<T>{}(value);
+    }
+}
+
+template <class T>
+bool same(const T& left, const T& right) {
+    if constexpr(IsShared<T>::value) {
+        return left == right;
+    } else if constexpr(IsOptional<T>::value) {
+        return left.has_value() == right.has_value() && (!left || same(*left, *right));
+    } else if constexpr(requires { equalValue(left, right); }) {
+        return equalValue(left, right);
+    } else if constexpr(std::is_convertible_v<const T&, std::string_view>) {
+        return std::string_view{left} == std::string_view{right};
+    } else if constexpr(BytewiseRange<T>) {
+        return rangeBytes(left) == rangeBytes(right);
+    } else if constexpr(std::ranges::range<T>) {
+        return std::ranges::equal(left, right, [](const auto& a, const auto& b) { return same(a, b); });
+    } else {
+        return left == right;
+    }
+}
+
+} // namespace
+
+)"sv;
+
+// Поле может совпадать побайтно у равных значений: целое, перечисление или FixedString
+// без std::optional. Отсутствие дополнения проверяется при компиляции (bytewise<T>)
+bool plainField(const Field& field) {
+    if(field.isOptional || field.isRepeated() || field.isShared) return false;
+    switch(field.kind) {
+    case Field::Kind::Enum: return true;
+    case Field::Kind::Scalar: return field.type != "float" && field.type != "double";
+    case Field::Kind::String: return field.type.starts_with("FixedString");
+    default: return false;
+    }
+}
+
+// Структурные хеш и равенство одной структуры: только поля схемы, без индексов
+string hashCode(const ComplexType& complexType) {
+    std::stringstream ss;
+    // Структуры из одних простых полей без дополнения сравниваются и хешируются целиком
+    const bool plain = !complexType.fields.empty() && complexType.constraints.empty()
+        && std::ranges::all_of(complexType.fields, plainField);
+    println(ss, "std::size_t hashValue(const {}&{}) {{", complexType.name, complexType.fields.empty() ? "" : " value");
+    if(plain) println(ss, "    if constexpr(bytewise<{}>) return std::hash<std::string_view>{{}}(objectBytes(value));", complexType.name);
+    println(ss, "    std::size_t seed = {};", complexType.fields.size());
+    for(const auto& field: complexType.fields) {
+        println(ss, "    combine(seed, hashOf(value.{}));", field.name);
+    }
+    println(ss, "    return seed;");
+    println(ss, "}}\n");
+
+    if(complexType.fields.empty()) {
+        println(ss, "bool equalValue(const {0}&, const {0}&) {{ return true; }}\n", complexType.name);
+        return ss.str();
+    }
+    println(ss, "bool equalValue(const {0}& left, const {0}& right) {{", complexType.name);
+    if(plain) println(ss, "    if constexpr(bytewise<{}>) return std::memcmp(&left, &right, sizeof left) == 0;", complexType.name);
+    for(size_t i = 0; i < complexType.fields.size(); ++i) {
+        const string& name = complexType.fields[i].name;
+        println(ss, "    {0} same(left.{1}, right.{1}){2}", i ? "    &&" : "return", name, i + 1 == complexType.fields.size() ? ";" : "");
+    }
+    println(ss, "}}\n");
+    return ss.str();
+}
+
+} // namespace
+
+// Коллекции вложенных структур, элементы которых разделяются при загрузке (Options::intern).
+// Ленивые коллекции хранят свои элементы сами; коллекции, по которым строятся индексы
+// xs:key/xs:keyref, остаются std::vector<T>
+void Parser::markSharedFields() {
+    auto indexed = [this](const Field& field) {
+        for(const auto& complexType: complexTypes) {
+            for(const auto& constraint: complexType.constraints) {
+                const Field& items = constraint.path.back();
+                if(items.name == field.name && items.type == field.type) return true;
+            }
+        }
+        return false;
+    };
+    for(auto& complexType: complexTypes) {
+        for(auto& field: complexType.fields) {
+            field.isShared = field.kind == Field::Kind::Complex && field.isRepeated()
+                && !options_.isLazy(field) && !indexed(field);
+        }
+    }
+}
+
+string_view Parser::sharedDefinition() { return sharedDeclaration; }
+string_view Parser::internDefinition() { return internDeclaration; }
+
+// Структурные хеш и равенство всех структур (Options::structuralHash)
+bool Parser::generateHash(const string& outputDir, const string& namespaceName) const {
+    std::ofstream source(outputDir + "/Hash.cpp");
+    if(!source.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Hash.cpp", outputDir);
+        return false;
+    }
+
+    println(source, "#include \"Types.h\"");
+    println(source, "#include <algorithm>");
+    println(source, "#include <cstring>");
+    println(source, "#include <functional>");
+    println(source, "#include <ranges>");
+    println(source, "#include <string_view>");
+    println(source, "#include <type_traits>\n");
+    if(!namespaceName.empty()) {
+        println(source, "namespace {} {{\n", namespaceName);
+    }
+    source << hashHelpersBegin;
+    if(options_.intern) source << isSharedSpecialization;
+    source << hashHelpersEnd;
+    for(const auto& complexType: complexTypes) {
+        source << hashCode(complexType);
+    }
+    if(!namespaceName.empty()) {
+        println(source, "}} // namespace {}", namespaceName);
+    }
+    return true;
+}
+
+} // namespace Xsd
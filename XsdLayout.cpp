@@ -0,0 +1,205 @@
+#include "XsdParser.h"
+#include <charconv>
+#include <format>
+#include <iostream>
+#include <ranges>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Размер и выравнивание типа C++.
+// Модель - LP64 и libstdc++ (x86-64/AArch64 Linux): std::string 32 байта, std::vector 24,
+// std::optional<T> - T и флаг, дополненные до выравнивания T
+struct Layout {
+    uint32_t size{0};
+    uint32_t align{1};
+};
+
+constexpr Layout stringLayout{32, 8};
+constexpr Layout vectorLayout{24, 8};
+constexpr Layout lazyLayout{40, 8};         // Два указателя и std::vector
+constexpr Layout unorderedMapLayout{56, 8}; // Индексы xs:key/xs:unique
+
+uint32_t alignUp(uint32_t size, uint32_t align) { return (size + align - 1) / align * align; }
+
+Layout optionalOf(Layout value) {
+    return {alignUp(value.size + 1, value.align), value.align};
+}
+
+// Член структуры в порядке объявления
+struct Member {
+    string name;
+    Layout layout;
+    uint32_t offset{0};
+};
+
+// Раскладка структуры: члены в порядке объявления, размер и выравнивание с учётом хвостового дополнения
+struct StructLayout {
+    string name{};
+    vector<Member> members{};
+    Layout layout{};
+
+    uint32_t padding() const {
+        uint32_t used = 0;
+        for(const auto& member: members) used += member.layout.size;
+        return layout.size - used;
+    }
+};
+
+// Раскладка сгенерированных структур по выбранным типам полей
+class LayoutModel {
+public:
+    LayoutModel(const vector<ComplexType>& complexTypes, const vector<Enum>& enums, const Options& options)
+        : enums_{enums}
+        , options_{options} {
+        for(const auto& complexType: complexTypes) types_.emplace(complexType.name, &complexType);
+    }
+
+    // Раскладка структуры с членами в заданном порядке (пусто - порядок memberOrder типа)
+    StructLayout layout(const ComplexType& complexType, const vector<size_t>& order = {}) {
+        StructLayout result{.name = complexType.name};
+        const auto& memberOrder = order.empty() ? complexType.memberOrder : order;
+        for(size_t i = 0; i < complexType.fields.size(); ++i) {
+            const Field& field = complexType.fields[memberOrder.empty() ? i : memberOrder[i]];
+            result.members.push_back({field.name, fieldLayout(field)});
+        }
+        // Индексы объявляются после полей (generateIndexDecl)
+        for(const auto& constraint: complexType.constraints) {
+            const bool isKeyRef = constraint.kind == IdentityConstraint::Kind::KeyRef;
+            result.members.push_back({constraint.name + (isKeyRef ? "Targets" : "Index"), isKeyRef ? vectorLayout : unorderedMapLayout});
+        }
+
+        uint32_t offset = 0;
+        for(auto& member: result.members) {
+            member.offset = alignUp(offset, member.layout.align);
+            offset = member.offset + member.layout.size;
+            result.layout.align = std::max(result.layout.align, member.layout.align);
+        }
+        // Пустая структура занимает байт
+        result.layout.size = std::max(alignUp(offset, result.layout.align), 1u);
+        return result;
+    }
+
+    // Порядок полей по убыванию выравнивания; при равном - порядок схемы.
+    // Размеры всех типов кратны их выравниванию, поэтому дополнение остаётся только в хвосте
+    vector<size_t> packedOrder(const ComplexType& complexType) {
+        vector<size_t> order(complexType.fields.size());
+        for(size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::ranges::stable_sort(order, std::greater{}, [&](size_t i) { return fieldLayout(complexType.fields[i]).align; });
+        return order;
+    }
+
+    Layout fieldLayout(const Field& field) {
+        Layout value;
+        if(options_.isLazy(field)) value = lazyLayout;
+        else if(field.isRepeated()) value = vectorLayout;
+        else value = valueLayout(field);
+        return field.isOptional && !field.isRepeated() ? optionalOf(value) : value;
+    }
+
+private:
+    Layout valueLayout(const Field& field) {
+        switch(field.kind) {
+        case Field::Kind::String: {
+            if(field.type == "PooledString") return {8, 8}; // Указатель на строку пула
+            // FixedString<N>: N байт, нуль-терминатор и длина uint8_t/uint16_t
+            constexpr auto prefix = "FixedString<"sv;
+            if(!field.type.starts_with(prefix)) return stringLayout;
+            uint32_t capacity = 0;
+            std::from_chars(field.type.data() + prefix.size(), field.type.data() + field.type.size(), capacity);
+            const uint32_t lengthSize = capacity < 256 ? 1 : 2;
+            return {alignUp(capacity + 1 + lengthSize, lengthSize), lengthSize};
+        }
+        case Field::Kind::Binary: return vectorLayout;
+        case Field::Kind::Scalar: {
+            if(field.type == "bool") return {1, 1};
+            if(field.type == "float") return {4, 4};
+            if(field.type == "double") return {8, 8};
+            const IntegerType* integer = IntegerType::find(field.type);
+            const uint32_t size = integer ? integer->size : 8;
+            return {size, size};
+        }
+        case Field::Kind::Enum: {
+            auto it = std::ranges::find(enums_, field.type, &Enum::name);
+            const string_view underlying = it != enums_.end() ? it->underlyingType() : ""sv;
+            const uint32_t size = underlying == "std::uint8_t" ? 1 : underlying == "std::uint16_t" ? 2 : 4;
+            return {size, size};
+        }
+        case Field::Kind::Complex: return complexLayout(field.type);
+        }
+        return stringLayout;
+    }
+
+    Layout complexLayout(const string& name) {
+        if(auto it = cache_.find(name); it != cache_.end()) return it->second;
+        auto type = types_.find(name);
+        if(type == types_.end()) return stringLayout;
+        // Защита от циклов через некорректную схему: структура не может содержать себя по значению
+        cache_[name] = {};
+        return cache_[name] = layout(*type->second).layout;
+    }
+
+    const vector<Enum>& enums_;
+    const Options& options_;
+    std::map<string, const ComplexType*> types_;
+    std::map<string, Layout> cache_;
+};
+
+} // namespace
+
+// Порядок объявления полей в Types.h по убыванию выравнивания (Options::reorderMembers).
+// Сериализация, Descriptors.h и бинарный формат по-прежнему следуют порядку схемы в fields
+void Parser::reorderMembers() {
+    LayoutModel model{complexTypes, enums, options_};
+    for(auto& complexType: complexTypes) {
+        complexType.memberOrder = model.packedOrder(complexType);
+    }
+}
+
+// Размер, выравнивание и потери на выравнивание каждой структуры, худшие - первыми
+void Parser::printLayoutReport() const {
+    LayoutModel model{complexTypes, enums, options_};
+
+    struct Row {
+        StructLayout current;
+        StructLayout packed;
+    };
+    vector<Row> rows;
+    for(const auto& complexType: complexTypes) {
+        rows.push_back({model.layout(complexType), model.layout(complexType, model.packedOrder(complexType))});
+    }
+    std::ranges::stable_sort(rows, std::greater{}, [](const Row& row) { return row.current.padding(); });
+
+    uint32_t totalSize = 0, totalPadding = 0, totalPacked = 0;
+    println(std::cout, "\n=== Layout (LP64, libstdc++) ===");
+    println(std::cout, "{:<40} {:>7} {:>6} {:>8} {:>7}", "Struct", "sizeof", "align", "padding", "packed");
+    for(const auto& [current, packed]: rows) {
+        println(std::cout, "{:<40} {:>7} {:>6} {:>8} {:>7}", current.name, current.layout.size, current.layout.align, current.padding(), packed.layout.size);
+        totalSize += current.layout.size;
+        totalPadding += current.padding();
+        totalPacked += packed.layout.size;
+    }
+    println(std::cout, "Total: {} bytes, {} padding, {} after reordering", totalSize, totalPadding, totalPacked);
+
+    // Худшие структуры: члены с дополнением перед ними
+    println(std::cout, "\nWorst offenders:");
+    for(const auto& [current, packed]: rows | std::views::take(5)) {
+        if(current.padding() == 0) break;
+        println(std::cout, "  - {}: {} of {} bytes padding", current.name, current.padding(), current.layout.size);
+        uint32_t end = 0;
+        for(const auto& member: current.members) {
+            if(member.offset > end) {
+                println(std::cout, "      {} bytes before {} (offset {})", member.offset - end, member.name, member.offset);
+            }
+            end = member.offset + member.layout.size;
+        }
+        if(current.layout.size > end) {
+            println(std::cout, "      {} bytes tail padding", current.layout.size - end);
+        }
+    }
+}
+
+} // namespace Xsd
@@ -0,0 +1,218 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Места учёта и размер значений в куче (Memory.h)
+constexpr auto memoryDeclaration = R"(namespace memory {
+
+// Место учёта: тип (число объектов и их размер) или путь поля Тип.поле
+// (число прочитанных значений и принадлежащие им байты в куче).
+// Места создаются при первом проходе загрузки через них и не уничтожаются
+class Site {
+public:
+    explicit Site(const char* path);
+    Site(const Site&) = delete;
+    Site& operator=(const Site&) = delete;
+
+    void add(std::size_t bytes) {
+        count_.fetch_add(1, std::memory_order_relaxed);
+        bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    const char* path() const { return path_; }
+    std::size_t count() const { return count_.load(std::memory_order_relaxed); }
+    std::size_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+    const Site* next() const { return next_; }
+    void reset() {
+        count_.store(0, std::memory_order_relaxed);
+        bytes_.store(0, std::memory_order_relaxed);
+    }
+
+    // Первое место в списке всех мест; список только растёт
+    static Site* first();
+
+private:
+    const char* path_;
+    std::atomic<std::size_t> count_{0};
+    std::atomic<std::size_t> bytes_{0};
+    Site* next_ = nullptr;
+};
+
+template <class T>
+struct IsVector : std::false_type { };
+template <class T>
+struct IsVector<std::vector<T>> : std::true_type { };
+
+// Байты в куче, принадлежащие значению поля. Вложенные структуры учитываются
+// собственными местами, поэтому здесь считаются только буферы строк и коллекций
+template <class T>
+std::size_t heapBytes(const T& value) {
+    if constexpr(std::is_same_v<T, std::string>) {
+        // Короткая строка хранится в самом объекте
+        const char* data = value.data();
+        const char* self = reinterpret_cast<const char*>(&value);
+        return data >= self && data < self + sizeof value ? 0 : value.capacity() + 1;
+    } else if constexpr(IsVector<T>::value) {
+        std::size_t bytes = value.capacity() * sizeof(typename T::value_type);
+        for(const auto& item: value) bytes += heapBytes(item);
+        return bytes;
+    } else if constexpr(requires { value.has_value(); *value; }) {
+        return value ? heapBytes(*value) : 0;
+    } else {
+        return 0;
+    }
+}
+
+} // namespace memory
+
+// Отчёт о памяти моделей, загруженных readXml с момента запуска или resetMemoryReport():
+// объекты каждого типа и байты в куче по путям полей
+std::string memoryReport();
+void resetMemoryReport();
+)"sv;
+
+constexpr auto memoryDefinition = R"(namespace memory {
+
+namespace {
+
+std::atomic<Site*> head{nullptr};
+
+struct Row {
+    std::string_view path;
+    std::size_t count = 0;
+    std::size_t bytes = 0;
+};
+
+void printRows(std::string& out, std::vector<Row>& rows, const char* title, const char* unit) {
+    std::ranges::sort(rows, [](const Row& left, const Row& right) {
+        return left.bytes != right.bytes ? left.bytes > right.bytes : left.path < right.path;
+    });
+    out += title;
+    for(const auto& row: rows) {
+        char line[256];
+        std::snprintf(line, sizeof line, "  %-48.*s %10zu %s %12zu bytes\n",
+            static_cast<int>(row.path.size()), row.path.data(), row.count, unit, row.bytes);
+        out += line;
+    }
+}
+
+} // namespace
+
+Site::Site(const char* path)
+    : path_{path}
+    , next_{head.load(std::memory_order_relaxed)} {
+    while(!head.compare_exchange_weak(next_, this, std::memory_order_release, std::memory_order_relaxed)) { }
+}
+
+Site* Site::first() {
+    return head.load(std::memory_order_acquire);
+}
+
+} // namespace memory
+
+std::string memoryReport() {
+    if(!XSD_GENERATED_MEMORY_REPORT) return "Memory report disabled: compile with XSD_GENERATED_MEMORY_REPORT=1\n";
+
+    // Одно место на путь; строки типов - без точки в пути
+    std::map<std::string_view, memory::Row> merged;
+    for(const memory::Site* site = memory::Site::first(); site; site = site->next()) {
+        auto& row = merged[site->path()];
+        row.path = site->path();
+        row.count += site->count();
+        row.bytes += site->bytes();
+    }
+    std::vector<memory::Row> types;
+    std::vector<memory::Row> fields;
+    std::size_t heap = 0;
+    for(const auto& [path, row]: merged) {
+        if(path.find('.') == std::string_view::npos) {
+            types.push_back(row);
+        } else {
+            fields.push_back(row);
+            heap += row.bytes;
+        }
+    }
+
+    std::string out;
+    memory::printRows(out, types, "Objects by type (size includes storage counted under fields):\n", "objects");
+    memory::printRows(out, fields, "Heap by field:\n", "values ");
+    out += "Total heap owned by fields: " + std::to_string(heap) + " bytes\n";
+    return out;
+}
+
+void resetMemoryReport() {
+    for(memory::Site* site = memory::Site::first(); site; site = const_cast<memory::Site*>(site->next())) site->reset();
+}
+)"sv;
+
+} // namespace
+
+// Учёт памяти загруженных моделей (Options::memoryReport): Memory.h с местами учёта
+// и макросом XSD_GENERATED_MEMORY_SITE, которым readXml отмечает типы и поля.
+// Без XSD_GENERATED_MEMORY_REPORT=1 макрос пуст, а Reader.cpp не отличается от обычного
+bool Parser::generateMemory(const string& outputDir, const string& namespaceName) const {
+    std::ofstream header(outputDir + "/Memory.h");
+    if(!header.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Memory.h", outputDir);
+        return false;
+    }
+
+    const string scope = namespaceName.empty() ? "::" : "::" + namespaceName + "::";
+    println(header, "#pragma once\n");
+    println(header, "#include <atomic>");
+    println(header, "#include <cstddef>");
+    println(header, "#include <string>");
+    println(header, "#include <type_traits>");
+    println(header, "#include <vector>\n");
+    println(header, "// Учёт памяти при загрузке включается при компиляции: -DXSD_GENERATED_MEMORY_REPORT=1");
+    println(header, "// (CMake: -DXSD_GENERATED_MEMORY_REPORT=ON). Без него места учёта не создаются");
+    println(header, "#ifndef XSD_GENERATED_MEMORY_REPORT");
+    println(header, "#define XSD_GENERATED_MEMORY_REPORT 0");
+    println(header, "#endif\n");
+    println(header, "// Отмечает прохождение места path с bytes байтами; выключенный учёт не вычисляет bytes");
+    println(header, "#if XSD_GENERATED_MEMORY_REPORT");
+    println(header, "#define XSD_GENERATED_MEMORY_SITE(path, bytes) \\");
+    println(header, "    do {{ \\");
+    println(header, "        static {}memory::Site site{{path}}; \\", scope);
+    println(header, "        site.add(bytes); \\");
+    println(header, "    }} while(false)");
+    println(header, "#else");
+    println(header, "#define XSD_GENERATED_MEMORY_SITE(path, bytes) ((void)0)");
+    println(header, "#endif\n");
+    if(!namespaceName.empty()) {
+        println(header, "namespace {} {{\n", namespaceName);
+    }
+    header << memoryDeclaration;
+    if(!namespaceName.empty()) {
+        println(header, "\n}} // namespace {}", namespaceName);
+    }
+    header.close();
+
+    std::ofstream source(outputDir + "/Memory.cpp");
+    if(!source.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Memory.cpp", outputDir);
+        return false;
+    }
+
+    println(source, "#include \"Memory.h\"");
+    println(source, "#include <algorithm>");
+    println(source, "#include <cstdio>");
+    println(source, "#include <map>");
+    println(source, "#include <string_view>\n");
+    if(!namespaceName.empty()) {
+        println(source, "namespace {} {{\n", namespaceName);
+    }
+    source << memoryDefinition;
+    if(!namespaceName.empty()) {
+        println(source, "\n}} // namespace {}", namespaceName);
+    }
+    return true;
+}
+
+} // namespace Xsd
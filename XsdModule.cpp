@@ -0,0 +1,205 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+#include <sstream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Раздел модуля: заголовки глобального фрагмента и экспортируемые имена.
+// Модуль оборачивает сгенерированные заголовки объявлениями export using,
+// поэтому Reader.cpp, Writer.cpp и остальные единицы трансляции не меняются.
+struct ModuleUnit {
+    string partition{};           // Имя раздела (Types, Reader, ...), пустое - весь модуль
+    vector<string> headers{};     // Подключаются в глобальном фрагменте модуля
+    vector<string> names{};       // Имена пространства имён схемы
+    vector<string> metaNames{};   // Имена meta:: (Descriptors.h)
+    vector<string> binaryNames{}; // Имена binary:: (Binary.h)
+};
+
+void writeUsing(std::ostream& out, const string& namespaceName, const string& nested, const vector<string>& names) {
+    if(names.empty()) return;
+    string scope = namespaceName;
+    if(!nested.empty()) scope += (scope.empty() ? "" : "::") + nested;
+    if(scope.empty()) {
+        // Глобальное пространство имён
+        println(out, "export {{");
+        for(const auto& name: names) println(out, "    using ::{};", name);
+        println(out, "}}\n");
+        return;
+    }
+    println(out, "export namespace {} {{", scope);
+    for(const auto& name: names) println(out, "    using ::{}::{};", scope, name);
+    println(out, "}} // namespace {}\n", scope);
+}
+
+void writeUnit(std::ostream& out, const ModuleUnit& unit, const string& moduleName, const string& namespaceName) {
+    println(out, "// Интерфейс модуля, сгенерированный xsdTinyxml2ToCpp\n");
+    println(out, "module;\n");
+    for(const auto& header: unit.headers) {
+        println(out, "#include \"{}\"", header);
+    }
+    println(out);
+    if(unit.partition.empty()) {
+        println(out, "export module {};\n", moduleName);
+    } else {
+        println(out, "export module {}:{};\n", moduleName, unit.partition);
+    }
+    writeUsing(out, namespaceName, "", unit.names);
+    writeUsing(out, namespaceName, "meta", unit.metaNames);
+    writeUsing(out, namespaceName, "binary", unit.binaryNames);
+}
+
+} // namespace
+
+// Интерфейс модуля C++20 поверх сгенерированных заголовков (Options::modules)
+bool Parser::generateModule(const string& outputDir, const string& namespaceName) const {
+    const string moduleName = namespaceName.empty() ? "Generated" : namespaceName;
+
+    ModuleUnit types{.partition = "Types", .headers = {"Types.h"}};
+    for(const auto& enumType: enums) {
+        types.names.push_back(enumType.name);
+    }
+    // Преобразования перечислений в лёгком режиме вынесены из Types.h
+    if(options_.leanHeaders) {
+        types.headers.push_back("Enums_io.h");
+    }
+    types.names.insert(types.names.end(), {"Enum", "stringTo"});
+    if(std::ranges::any_of(enums, [](const Enum& enumType) { return !enumType.values.empty(); })) {
+        types.names.push_back("toString");
+    }
+    if(std::ranges::any_of(complexTypes, [](const ComplexType& type) { return !type.constraints.empty(); })) {
+        types.names.push_back("KeyHash");
+    }
+    if(options_.lazyCollections) {
+        types.names.push_back("Lazy");
+    }
+    if(options_.inlineStrings > 0) {
+        types.names.push_back("FixedString");
+    }
+    if(options_.isPooling()) {
+        types.names.insert(types.names.end(), {"StringPool", "currentStringPool", "StringPoolScope", "PooledString"});
+    }
+    for(const auto& complexType: complexTypes) {
+        types.names.push_back(complexType.name);
+    }
+    if(options_.intern) {
+        types.names.push_back("Shared");
+    }
+    if(options_.hasHash()) {
+        types.names.insert(types.names.end(), {"hashValue", "equalValue"});
+    }
+    if(options_.descriptors) {
+        types.headers.push_back("Descriptors.h");
+        types.metaNames = {"Kind", "Occurs", "Node", "FieldDescriptor", "Descriptor", "visit", "hasContent"};
+    }
+
+    ModuleUnit reader{.partition = "Reader", .headers = {"Reader.h"}};
+    reader.names = {"throwMissing", "ParsedInteger", "parseInteger", "narrowInteger", "readValue", "readXml", "readDocument",
+        "Document", "loadDocument", "parseDocument"};
+    if(!options_.lazyCollections) {
+        reader.names.insert(reader.names.end(), {"loadXml", "parseXml"});
+    }
+    if(options_.parallelCollections) {
+        reader.names.insert(reader.names.end(), {"LoadPool", "parallelMinItems", "readCollection"});
+    }
+    if(options_.descriptors) {
+        reader.names.push_back("readFields");
+    }
+    if(options_.streaming || options_.batch || options_.intern || options_.isPooling()) {
+        reader.names.insert(reader.names.end(), {"Record", "readRecord", "loadRecord"});
+    }
+    if(options_.intern) {
+        reader.names.insert(reader.names.end(), {"Interner", "currentInterner", "InternScope", "loadInterned", "parseInterned"});
+    }
+    if(options_.isPooling()) {
+        reader.names.insert(reader.names.end(), {"loadPooled", "parsePooled"});
+    }
+    if(options_.expected) {
+        reader.headers.push_back("Expected.h");
+        reader.names.insert(reader.names.end(), {"ValueError", "LoadError", "Expected", "Status", "tryStringTo",
+            "tryParseInteger", "tryParseHex", "tryParse", "tryReadXml", "tryReadDocument", "tryLoadXml", "tryParseXml"});
+    }
+    if(options_.memoryReport) {
+        reader.headers.push_back("Memory.h");
+        reader.names.insert(reader.names.end(), {"memoryReport", "resetMemoryReport"});
+    }
+    if(options_.trace) {
+        reader.headers.push_back("Trace.h");
+        reader.names.insert(reader.names.end(), {"traceJson", "saveTrace", "resetTrace"});
+    }
+
+    ModuleUnit writer{.partition = "Writer", .headers = {"Writer.h"}};
+    writer.names = {"XmlSink", "writeValue", "writeXml", "toXml", "saveXml"};
+    if(options_.descriptors) {
+        writer.names.push_back("writeFields");
+    }
+
+    ModuleUnit binary{.partition = "Binary", .headers = {"Binary.h"}};
+    binary.binaryNames = {"formatVersion", "schemaHash", "Header", "read", "readString", "present",
+        "Element", "ArrayView", "slotSize", "Encoder", "MappedFile"};
+    for(const auto& complexType: complexTypes) {
+        binary.names.push_back(complexType.name + "View");
+    }
+    binary.names.insert(binary.names.end(), {"encodeBinary", "BinaryDocument", "encodeDocument", "saveBinary"});
+
+    ModuleUnit validate{.partition = "Validate", .headers = {"Validate.h"}};
+    validate.names = {"Violation", "Violations", "validate"};
+
+    const ModuleUnit* groups[]{&types, &reader, &writer, &binary, &validate};
+
+    std::ofstream primary(outputDir + "/" + moduleName + ".cppm");
+    if(!primary.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/{}.cppm", outputDir, moduleName);
+        return false;
+    }
+
+    if(!options_.modulePartitions) {
+        // Один интерфейсный модуль со всеми группами
+        ModuleUnit all;
+        for(const auto* group: groups) {
+            all.headers.insert(all.headers.end(), group->headers.begin(), group->headers.end());
+            all.names.insert(all.names.end(), group->names.begin(), group->names.end());
+            all.metaNames.insert(all.metaNames.end(), group->metaNames.begin(), group->metaNames.end());
+            all.binaryNames.insert(all.binaryNames.end(), group->binaryNames.begin(), group->binaryNames.end());
+        }
+        writeUnit(primary, all, moduleName, namespaceName);
+        return true;
+    }
+
+    // Основной интерфейс реэкспортирует разделы: каждый раздел разбирает только свои заголовки,
+    // разделы собираются независимо друг от друга
+    println(primary, "// Интерфейс модуля, сгенерированный xsdTinyxml2ToCpp\n");
+    println(primary, "export module {};\n", moduleName);
+    for(const auto* group: groups) {
+        println(primary, "export import :{};", group->partition);
+    }
+
+    for(const auto* group: groups) {
+        const string path = std::format("{}/{}-{}.cppm", outputDir, moduleName, group->partition);
+        std::ofstream unit(path);
+        if(!unit.is_open()) {
+            println(std::cerr, "Не удалось создать файл: {}", path);
+            return false;
+        }
+        writeUnit(unit, *group, moduleName, namespaceName);
+    }
+    return true;
+}
+
+// Файлы интерфейса модуля для FILE_SET CXX_MODULES в CMakeLists.txt
+vector<string> Parser::moduleFiles(const string& namespaceName) const {
+    const string moduleName = namespaceName.empty() ? "Generated" : namespaceName;
+    vector<string> files{moduleName + ".cppm"};
+    if(options_.modulePartitions) {
+        for(const char* partition: {"Types", "Reader", "Writer", "Binary", "Validate"}) {
+            files.push_back(std::format("{}-{}.cppm", moduleName, partition));
+        }
+    }
+    return files;
+}
+
+} // namespace Xsd
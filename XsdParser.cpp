@@ -1,4 +1,5 @@
 #include "XsdParser.h"
+#include <charconv>
 #include <filesystem>
 #include <format>
 #include <iomanip>
@@ -15,6 +16,221 @@ constexpr auto testName(std::string_view src, std::string_view dst) -> bool {
     return src == dst || src == dst.substr(3);
 };
 
+// Преобразование строк в перечисления (Enums.h, в режиме Options::leanHeaders - Enums_io.h)
+constexpr auto conversionDeclaration = R"(template <typename E>
+concept Enum = std::is_enum_v<E>;
+
+template <Enum E>
+E stringTo(const std::string& str);
+
+)"sv;
+
+// Замер времени компиляции потребителей (CMakeLists.txt, режим Options::leanHeaders).
+// Цель входит в сгенерированный проект, а не в сборку генератора: заголовки зависят от схемы.
+// cmake -DXSD_GENERATED_COMPILE_BENCH=ON ... && cmake --build . --target xsd_compile_bench
+constexpr auto compileBenchCMake = R"(
+# Время компиляции единицы трансляции, подключающей один сгенерированный заголовок
+option(XSD_GENERATED_COMPILE_BENCH "Замер времени компиляции потребителей сгенерированных заголовков" OFF)
+if(XSD_GENERATED_COMPILE_BENCH AND NOT MSVC)
+    add_custom_target(xsd_compile_bench
+        COMMAND ${{CMAKE_COMMAND}}
+            -DCOMPILER=${{CMAKE_CXX_COMPILER}}
+            -DSTANDARD=${{CMAKE_CXX_STANDARD}}
+            "-DINCLUDES=-I${{CMAKE_CURRENT_SOURCE_DIR}};-I$<JOIN:$<TARGET_PROPERTY:tinyxml2::tinyxml2,INTERFACE_INCLUDE_DIRECTORIES>,;-I>"
+            -DOUTPUT=${{CMAKE_CURRENT_BINARY_DIR}}/compile_bench
+            -DSTRUCTS={}
+            -DENUMS={}
+            -P ${{CMAKE_CURRENT_SOURCE_DIR}}/compile_bench.cmake
+        VERBATIM)
+endif()
+)"sv;
+
+// Встраивание экземпляров при сборке (CMakeLists.txt, режим Options::embed)
+constexpr auto embedCMake = R"(
+# Встраивание экземпляров: xsd_generated_embed файл.xml заголовок.h [имя]
+add_executable(xsd_generated_embed Embed.cpp)
+target_link_libraries(xsd_generated_embed PRIVATE xsd_generated)
+
+# Заголовок NAME.h с constexpr-значением экземпляра INSTANCE для цели TARGET, создаётся при сборке:
+# xsd_generated_embed_instance(firmware ${CMAKE_CURRENT_SOURCE_DIR}/device.xml device)
+function(xsd_generated_embed_instance TARGET INSTANCE NAME)
+    set(directory ${CMAKE_CURRENT_BINARY_DIR}/xsd_embedded)
+    add_custom_command(
+        OUTPUT ${directory}/${NAME}.h
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${directory}
+        COMMAND xsd_generated_embed ${INSTANCE} ${directory}/${NAME}.h ${NAME}
+        DEPENDS xsd_generated_embed ${INSTANCE}
+        VERBATIM)
+    target_sources(${TARGET} PRIVATE ${directory}/${NAME}.h)
+    target_include_directories(${TARGET} PRIVATE ${directory} ${Generated_SOURCE_DIR})
+endfunction()
+)"sv;
+
+// Учёт памяти при загрузке (CMakeLists.txt, режим Options::memoryReport)
+constexpr auto memoryCMake = R"(
+# Учёт памяти при загрузке, отчёт memoryReport(); выключенный не оставляет кода в readXml
+option(XSD_GENERATED_MEMORY_REPORT "Учёт памяти загруженных моделей по типам и полям" OFF)
+if(XSD_GENERATED_MEMORY_REPORT)
+    target_compile_definitions(xsd_generated PUBLIC XSD_GENERATED_MEMORY_REPORT=1)
+endif()
+)"sv;
+
+// Трассировка загрузки (CMakeLists.txt, режим Options::trace)
+constexpr auto traceCMake = R"(
+# Трассировка загрузки по элементам, traceJson()/saveTrace(); выключенная не оставляет кода в readXml
+option(XSD_GENERATED_TRACE "Трассировка загрузки в формате Chrome trace" OFF)
+if(XSD_GENERATED_TRACE)
+    target_compile_definitions(xsd_generated PUBLIC XSD_GENERATED_TRACE=1)
+endif()
+)"sv;
+
+// Скрипт замера (compile_bench.cmake): лучшее из нескольких -fsyntax-only для каждого заголовка
+constexpr auto compileBenchScript = R"(# Замер времени компиляции потребителей сгенерированных заголовков.
+# Запускается целью xsd_compile_bench (CMakeLists.txt, XSD_GENERATED_COMPILE_BENCH=ON).
+cmake_minimum_required(VERSION 3.23) # string(TIMESTAMP) с %f
+
+if(NOT REPEAT)
+    set(REPEAT 5)
+endif()
+
+# Каждый заголовок объявляет все структуры (complexType) и перечисления схемы
+message("Структур: ${STRUCTS}, перечислений: ${ENUMS}")
+foreach(header Types_fwd.h Types.h Reader.h Writer.h)
+    file(WRITE "${OUTPUT}/${header}.cpp" "#include \"${header}\"\n")
+    set(best "")
+    foreach(run RANGE 1 ${REPEAT})
+        string(TIMESTAMP start "%s%f" UTC)
+        execute_process(
+            COMMAND ${COMPILER} -std=c++${STANDARD} -fsyntax-only ${INCLUDES} "${OUTPUT}/${header}.cpp"
+            RESULT_VARIABLE result)
+        string(TIMESTAMP end "%s%f" UTC)
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "Не удалось скомпилировать ${header}")
+        endif()
+        math(EXPR elapsed "(${end} - ${start}) / 1000")
+        if(best STREQUAL "" OR elapsed LESS best)
+            set(best ${elapsed})
+        endif()
+    endforeach()
+    message("${header}: ${best} мс")
+endforeach()
+)"sv;
+
+// Хеш строковых ключей xs:key/xs:unique (Types.h)
+constexpr auto keyHashDeclaration = R"(// Прозрачный хеш: find_by_* ищут по std::string_view без создания std::string
+struct KeyHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+};
+
+)"sv;
+
+// Строка фиксированной ёмкости для режима Options::inlineStrings (Types.h)
+constexpr auto fixedStringDeclaration = R"(// Строка ёмкостью N байт, хранящая символы в самом объекте: без выделения памяти,
+// записи с такими полями остаются непрерывными в std::vector и копируются побайтно
+template <std::size_t N>
+class FixedString {
+public:
+    using size_type = std::conditional_t<(N < 256), std::uint8_t, std::uint16_t>;
+
+    constexpr FixedString() = default;
+    constexpr explicit FixedString(std::string_view text) {
+        if(!assign(text)) throw std::length_error("FixedString: capacity exceeded");
+    }
+
+    // false и прежнее значение, если text не помещается
+    constexpr bool assign(std::string_view text) {
+        if(text.size() > N) return false;
+        text.copy(data_, text.size());
+        // Хвост прежнего значения обнуляется: равные строки совпадают побайтно
+        for(std::size_t i = text.size(); i <= size_; ++i) data_[i] = '\0';
+        data_[text.size()] = '\0';
+        size_ = static_cast<size_type>(text.size());
+        return true;
+    }
+
+    static constexpr std::size_t capacity() { return N; }
+    constexpr std::size_t size() const { return size_; }
+    constexpr bool empty() const { return size_ == 0; }
+    constexpr const char* data() const { return data_; }
+    constexpr const char* c_str() const { return data_; }
+    constexpr const char* begin() const { return data_; }
+    constexpr const char* end() const { return data_ + size_; }
+    constexpr std::string_view view() const { return {data_, size_}; }
+    constexpr operator std::string_view() const { return view(); }
+
+    friend constexpr bool operator==(const FixedString& left, std::string_view right) { return left.view() == right; }
+    friend constexpr bool operator==(const FixedString& left, const FixedString& right) { return left.view() == right.view(); }
+    friend constexpr auto operator<=>(const FixedString& left, const FixedString& right) { return left.view() <=> right.view(); }
+
+private:
+    char data_[N + 1]{};
+    size_type size_{};
+};
+
+)"sv;
+
+// Ленивая коллекция для режима Options::lazyCollections (Types.h)
+constexpr auto lazyDeclaration = R"(// Ленивая коллекция: до первого обращения хранит только положение в исходном DOM,
+// затем один раз декодирует элементы и запоминает результат.
+// DOM должен жить дольше объекта (см. Document<T> в Reader.h).
+// Первое обращение из нескольких потоков требует внешней синхронизации.
+template <class T>
+class Lazy {
+public:
+    using value_type = T;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    Lazy() = default;
+    Lazy(const tinyxml2::XMLElement* parent, const char* tag)
+        : parent_{parent}
+        , tag_{tag} { }
+
+    const std::vector<T>& get() const {
+        if(parent_) load();
+        return items_;
+    }
+    std::vector<T>& get() {
+        if(parent_) load();
+        return items_;
+    }
+    bool isLoaded() const { return parent_ == nullptr; }
+
+    std::size_t size() const { return get().size(); }
+    bool empty() const { return get().empty(); }
+    const T& operator[](std::size_t index) const { return get()[index]; }
+    T& operator[](std::size_t index) { return get()[index]; }
+    const_iterator begin() const { return get().begin(); }
+    const_iterator end() const { return get().end(); }
+    iterator begin() { return get().begin(); }
+    iterator end() { return get().end(); }
+
+    void reserve(std::size_t size) { get().reserve(size); }
+    void push_back(const T& item) { get().push_back(item); }
+    void push_back(T&& item) { get().push_back(std::move(item)); }
+    template <class... Args>
+    T& emplace_back(Args&&... args) { return get().emplace_back(std::forward<Args>(args)...); }
+
+    // Сравнение загружает обе коллекции
+    friend bool operator==(const Lazy& left, const Lazy& right) { return left.get() == right.get(); }
+
+private:
+    void load() const;
+
+    mutable const tinyxml2::XMLElement* parent_{};
+    const char* tag_{};
+    mutable std::vector<T> items_;
+)"sv;
+
+// Строки коллекции читаются в пул, действовавший при загрузке документа, а не при обращении
+constexpr auto lazyPoolMember = R"(    StringPool* pool_ = currentStringPool;
+)"sv;
+
+constexpr auto lazyDeclarationEnd = R"(};
+
+)"sv;
+
 Parser::~Parser() { clear(); }
 
 bool Parser::parse(const string& filename) {
@@ -41,6 +257,12 @@ bool Parser::parse(const string& filename) {
 
     // Парсим схему
     parseSchema(root);
+    resolveFieldKinds();
+    if(options_.isPooling() && !markPooledStrings()) return false;
+    resolveIdentityConstraints();
+    if(options_.intern) markSharedFields();
+    if(options_.reorderMembers) reorderMembers();
+    if(options_.comparisons) resolveOrderings();
 
     std::cout << "Парсинг завершен успешно!" << std::endl;
     std::cout << "Найдено перечислений: " << enums.size() << std::endl;
@@ -67,24 +289,28 @@ bool Parser::generateCppCode(const string& outputDir,
         return false;
     }
 
-    // Заголовок файла с перечислениями
+    // Заголовок файла с перечислениями.
+    // В режиме leanHeaders Enums.h содержит только перечисления, преобразования - в Enums_io.h
+    const bool lean = options_.leanHeaders;
     println(enumHeader, "#pragma once\n");
-    println(enumHeader, "#include <string>");
-    println(enumHeader, "#include <map>");
-    println(enumHeader, "#include <stdexcept>\n");
+    println(enumHeader, "#include <cstdint>");
+    if(!lean) {
+        println(enumHeader, "#include <string>");
+        println(enumHeader, "#include <map>");
+        println(enumHeader, "#include <stdexcept>");
+    }
+    println(enumHeader);
 
     if(!namespaceName.empty()) {
         println(enumHeader, "namespace {} {{\n", namespaceName);
     }
 
-    println(enumHeader, "template <typename E>concept Enum=std::is_enum_v<E>;\n");
-    println(enumHeader, "template <Enum E>");
-    println(enumHeader, "E stringTo(const std::string& str);\n");
-    // println(enumHeader, "template <Enum E>");
-    // println(enumHeader, "std::string toString(E value);\n");
+    if(!lean) {
+        enumHeader << conversionDeclaration;
+    }
 
     for(const auto& enumType: enums) {
-        enumHeader << enumType.generateHeaderCode();
+        enumHeader << enumType.generateHeaderCode(!lean);
     }
 
     if(!namespaceName.empty()) {
@@ -93,6 +319,35 @@ bool Parser::generateCppCode(const string& outputDir,
 
     enumHeader.close();
 
+    if(lean) {
+        std::ofstream enumIo(outputDir + "/Enums_io.h");
+        if(!enumIo.is_open()) {
+            println(std::cerr, "Не удалось создать файл: {}/Enums_io.h", outputDir);
+            return false;
+        }
+
+        println(enumIo, "#pragma once\n");
+        println(enumIo, "#include <string>");
+        println(enumIo, "#include <type_traits>");
+        println(enumIo, "#include \"Enums.h\"\n");
+
+        if(!namespaceName.empty()) {
+            println(enumIo, "namespace {} {{\n", namespaceName);
+        }
+
+        enumIo << conversionDeclaration;
+
+        for(const auto& enumType: enums) {
+            enumIo << enumType.generateConversionDecl();
+        }
+
+        if(!namespaceName.empty()) {
+            println(enumIo, "}} // namespace {}", namespaceName);
+        }
+
+        enumIo.close();
+    }
+
     // Генерируем исходный файл с перечислениями
     std::ofstream enumSource(outputDir + "/Enums.cpp");
     if(!enumSource.is_open()) {
@@ -100,8 +355,13 @@ bool Parser::generateCppCode(const string& outputDir,
         return false;
     }
 
-    enumSource << "#include \"Enums.h\"\n";
-    enumSource << "#include <algorithm>\n\n";
+    enumSource << (lean ? "#include \"Enums_io.h\"\n" : "#include \"Enums.h\"\n");
+    enumSource << "#include <algorithm>\n";
+    if(lean) {
+        enumSource << "#include <map>\n";
+        enumSource << "#include <stdexcept>\n";
+    }
+    enumSource << "\n";
 
     if(!namespaceName.empty()) {
         enumSource << "namespace " << namespaceName << " {\n\n";
@@ -124,28 +384,133 @@ bool Parser::generateCppCode(const string& outputDir,
         return false;
     }
 
+    // В режиме leanHeaders Types.h не подключает tinyxml2 и <stdexcept>:
+    // определения, которым они нужны, уходят в Types.cpp и Reader.h
     println(structHeader, "#pragma once\n");
+    println(structHeader, "#include <cstdint>");
     println(structHeader, "#include <string>");
     println(structHeader, "#include <vector>");
     println(structHeader, "#include <optional>");
-    println(structHeader, "#include <stdexcept>");
-    println(structHeader, "#include \"tinyxml2.h\"");
-    println(structHeader, "#include \"Enums.h\"\n");
+    // FixedString сообщает о переполнении через std::length_error и в лёгком режиме
+    if(!lean || options_.inlineStrings > 0) {
+        println(structHeader, "#include <stdexcept>");
+    }
+    const bool hasConstraints = std::ranges::any_of(complexTypes, [](const ComplexType& type) { return !type.constraints.empty(); });
+    const bool pooling = options_.isPooling();
+    if(options_.hasHash() || pooling) {
+        println(structHeader, "#include <cstddef>");
+    }
+    if(options_.comparisons) {
+        println(structHeader, "#include <compare>");
+    }
+    if(hasConstraints || pooling || options_.comparisons) {
+        println(structHeader, "#include <functional>");
+    }
+    if(hasConstraints || options_.inlineStrings > 0 || pooling) {
+        println(structHeader, "#include <string_view>");
+    }
+    if(options_.inlineStrings > 0) {
+        println(structHeader, "#include <type_traits>");
+    }
+    if(hasConstraints) {
+        println(structHeader, "#include <unordered_map>");
+    }
+    if(pooling) {
+        println(structHeader, "#include <mutex>");
+        println(structHeader, "#include <unordered_set>");
+    }
+    if(options_.intern) {
+        println(structHeader, "#include <memory>");
+    }
+    if(!lean) {
+        println(structHeader, "#include \"tinyxml2.h\"");
+        println(structHeader, "#include \"Enums.h\"\n");
+    } else {
+        println(structHeader, "#include \"Types_fwd.h\"\n");
+        if(options_.lazyCollections) {
+            println(structHeader, "namespace tinyxml2 {{\nclass XMLElement;\n}} // namespace tinyxml2\n");
+        }
+    }
 
     if(!namespaceName.empty()) {
         println(structHeader, "namespace {} {{\n", namespaceName);
     }
 
+    if(options_.inlineStrings > 0) {
+        structHeader << fixedStringDeclaration;
+    }
+
+    if(pooling) {
+        structHeader << pooledStringDefinition();
+    }
+
+    if(hasConstraints) {
+        structHeader << keyHashDeclaration;
+    }
+
+    if(options_.lazyCollections) {
+        structHeader << lazyDeclaration;
+        if(pooling) structHeader << lazyPoolMember;
+        structHeader << lazyDeclarationEnd;
+        if(!lean) structHeader << lazyLoadDefinition(pooling);
+    }
+
+    if(options_.intern) {
+        structHeader << sharedDefinition();
+    }
+
     for(const auto& complexType: complexTypes) {
-        structHeader << complexType.generateHeaderCode();
+        structHeader << complexType.generateHeaderCode(namespaceName, options_);
+    }
+
+    // Структурные хеш и равенство определены в Hash.cpp
+    if(options_.hasHash()) {
+        for(const auto& complexType: complexTypes) {
+            println(structHeader, "std::size_t hashValue(const {}& value);", complexType.name);
+            println(structHeader, "bool equalValue(const {0}& left, const {0}& right);", complexType.name);
+        }
+        println(structHeader);
+    }
+
+    if(!lean) {
+        // Индексы определяются после всех структур: нужны полные типы элементов коллекций
+        for(const auto& complexType: complexTypes) {
+            if(!complexType.constraints.empty()) {
+                structHeader << complexType.generateIndexCode(namespaceName, options_);
+            }
+        }
+
+        // Lazy<T>::load() вызывает readXml и там, где Reader.h не подключён
+        if(options_.lazyCollections) {
+            for(const auto& complexType: complexTypes) {
+                structHeader << complexType.generateReaderDecl();
+            }
+            structHeader << '\n';
+        }
+    } else if(options_.lazyCollections) {
+        // Lazy<T>::load() явно инстанцируется в Reader.cpp
+        println(structHeader, "// Ленивые коллекции инстанцируются в Reader.cpp");
+        for(const auto& type: lazyItemTypes()) {
+            println(structHeader, "extern template class Lazy<{}>;", type);
+        }
+        println(structHeader);
     }
 
     if(!namespaceName.empty()) {
         println(structHeader, "}} // namespace {}", namespaceName);
     }
 
+    if(options_.comparisons) {
+        println(structHeader);
+        structHeader << hashSpecializations(namespaceName);
+    }
+
     structHeader.close();
 
+    if(lean && !generateLeanHeaders(outputDir, namespaceName)) {
+        return false;
+    }
+
     if(0) { // Генерируем исходный файл со структурами
         std::ofstream structSource(outputDir + "/Types.cpp");
         if(!structSource.is_open()) {
@@ -171,19 +536,124 @@ bool Parser::generateCppCode(const string& outputDir,
         structSource.close();
     }
 
+    // Таблицы описаний полей для обобщённых загрузки и сериализации
+    if(options_.descriptors && !generateDescriptors(outputDir, namespaceName)) {
+        return false;
+    }
+
+    // Генерируем потоковую сериализацию и загрузку
+    if(!generateWriter(outputDir, namespaceName) || !generateReader(outputDir, namespaceName)) {
+        return false;
+    }
+
+    // Генерируем бинарный формат с чтением на месте
+    if(!generateBinary(outputDir, namespaceName)) {
+        return false;
+    }
+
+    // Генерируем проверку фасетов простых типов
+    if(!generateValidator(outputDir, namespaceName)) {
+        return false;
+    }
+
+    // Интерфейс модуля поверх заголовков
+    if(options_.modules && !generateModule(outputDir, namespaceName)) {
+        return false;
+    }
+
+    // Структурные хеш и равенство
+    if(options_.hasHash() && !generateHash(outputDir, namespaceName)) {
+        return false;
+    }
+
+    // Потоковая загрузка записей
+    if(options_.streaming && !generateStream(outputDir, namespaceName)) {
+        return false;
+    }
+
+    // Пакетная загрузка файлов
+    if(options_.batch && !generateBatch(outputDir, namespaceName)) {
+        return false;
+    }
+
+    // Загрузка без исключений
+    if(options_.expected && !generateExpected(outputDir, namespaceName)) {
+        return false;
+    }
+
+    // Программа замера производительности
+    if(options_.bench && !generateBench(outputDir, namespaceName)) {
+        return false;
+    }
+
+    // Встраивание экземпляров в программу
+    if(options_.embed && !generateEmbed(outputDir, namespaceName)) {
+        return false;
+    }
+
+    // Учёт памяти при загрузке
+    if(options_.memoryReport && !generateMemory(outputDir, namespaceName)) {
+        return false;
+    }
+
+    // Трассировка загрузки
+    if(options_.trace && !generateTrace(outputDir, namespaceName)) {
+        return false;
+    }
+
     // Генерируем CMakeLists.txt для удобства
     std::ofstream cmakeFile(outputDir + "/CMakeLists.txt");
     if(cmakeFile.is_open()) {
-        println(cmakeFile, "cmake_minimum_required(VERSION 3.10)");
+        // FILE_SET CXX_MODULES поддерживается начиная с CMake 3.28
+        println(cmakeFile, "cmake_minimum_required(VERSION {})", options_.modules ? "3.28" : "3.10");
         println(cmakeFile, "project(Generated)\n");
-        println(cmakeFile, "set(CMAKE_CXX_STANDARD 20)\n");
+        // std::generator (Stream.h) и std::expected (Expected.h) появились в C++23
+        println(cmakeFile, "set(CMAKE_CXX_STANDARD {})\n", options_.streaming || options_.expected ? 23 : 20);
         println(cmakeFile, "# Находим tinyxml2");
         println(cmakeFile, "find_package(tinyxml2 REQUIRED)\n");
+        if(options_.parallelCollections || options_.batch) {
+            println(cmakeFile, "# Пул потоков параллельной и пакетной загрузки");
+            println(cmakeFile, "find_package(Threads REQUIRED)\n");
+        }
         println(cmakeFile, "# Создаем библиотеку");
         println(cmakeFile, "add_library(xsd_generated");
         println(cmakeFile, "    Enums.cpp");
-        println(cmakeFile, "    Types.cpp");
+        if(lean && hasConstraints) {
+            println(cmakeFile, "    Types.cpp");
+        }
+        println(cmakeFile, "    Writer.cpp");
+        println(cmakeFile, "    Reader.cpp");
+        println(cmakeFile, "    Binary.cpp");
+        println(cmakeFile, "    Validate.cpp");
+        if(options_.hasHash()) {
+            println(cmakeFile, "    Hash.cpp");
+        }
+        if(options_.streaming) {
+            println(cmakeFile, "    Stream.cpp");
+        }
+        if(options_.batch) {
+            println(cmakeFile, "    Batch.cpp");
+        }
+        if(options_.expected) {
+            println(cmakeFile, "    Expected.cpp");
+        }
+        if(options_.memoryReport) {
+            println(cmakeFile, "    Memory.cpp");
+        }
+        if(options_.trace) {
+            println(cmakeFile, "    Trace.cpp");
+        }
         println(cmakeFile, ")\n");
+        if(options_.modules) {
+            println(cmakeFile, "# Интерфейс модуля: import {};", namespaceName.empty() ? "Generated" : namespaceName);
+            println(cmakeFile, "target_sources(xsd_generated");
+            println(cmakeFile, "    PUBLIC");
+            println(cmakeFile, "        FILE_SET CXX_MODULES FILES");
+            for(const auto& file: moduleFiles(namespaceName)) {
+                println(cmakeFile, "            {}", file);
+            }
+            println(cmakeFile, ")\n");
+        }
         println(cmakeFile, "target_include_directories(xsd_generated");
         println(cmakeFile, "    PUBLIC");
         println(cmakeFile, "        ${{CMAKE_CURRENT_SOURCE_DIR}}");
@@ -191,7 +661,29 @@ bool Parser::generateCppCode(const string& outputDir,
         println(cmakeFile, "target_link_libraries(xsd_generated");
         println(cmakeFile, "    PUBLIC");
         println(cmakeFile, "        tinyxml2::tinyxml2");
+        if(options_.parallelCollections || options_.batch) {
+            println(cmakeFile, "        Threads::Threads");
+        }
         println(cmakeFile, ")");
+        if(options_.memoryReport) {
+            cmakeFile << memoryCMake;
+        }
+        if(options_.trace) {
+            cmakeFile << traceCMake;
+        }
+        if(options_.bench && rootElement()) {
+            println(cmakeFile, "\n# Замер производительности: xsd_generated_bench [-n повторов] файл.xml...");
+            println(cmakeFile, "add_executable(xsd_generated_bench Bench.cpp)");
+            println(cmakeFile, "target_link_libraries(xsd_generated_bench PRIVATE xsd_generated)");
+        }
+        if(options_.embed && rootElement()) {
+            cmakeFile << embedCMake;
+        }
+        if(lean) {
+            cmakeFile << std::format(compileBenchCMake, complexTypes.size(), enums.size());
+            std::ofstream benchScript(outputDir + "/compile_bench.cmake");
+            benchScript << compileBenchScript;
+        }
         cmakeFile.close();
     }
 
@@ -199,10 +691,87 @@ bool Parser::generateCppCode(const string& outputDir,
     return true;
 }
 
+// Типы элементов ленивых коллекций (для явного инстанцирования Lazy<T>)
+vector<string> Parser::lazyItemTypes() const {
+    vector<string> types;
+    for(const auto& complexType: complexTypes) {
+        for(const auto& field: complexType.fields) {
+            if(options_.isLazy(field) && std::ranges::find(types, field.type) == types.end()) {
+                types.push_back(field.type);
+            }
+        }
+    }
+    return types;
+}
+
+// Types_fwd.h с предварительными объявлениями и Types.cpp с определениями индексов
+bool Parser::generateLeanHeaders(const string& outputDir, const string& namespaceName) const {
+    std::ofstream forward(outputDir + "/Types_fwd.h");
+    if(!forward.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Types_fwd.h", outputDir);
+        return false;
+    }
+
+    println(forward, "#pragma once\n");
+    println(forward, "#include \"Enums.h\"\n");
+
+    if(!namespaceName.empty()) {
+        println(forward, "namespace {} {{\n", namespaceName);
+    }
+
+    if(options_.lazyCollections) {
+        println(forward, "template <class T>\nclass Lazy;\n");
+    }
+    for(const auto& complexType: complexTypes) {
+        println(forward, "struct {};", complexType.name);
+    }
+
+    if(!namespaceName.empty()) {
+        println(forward, "\n}} // namespace {}", namespaceName);
+    }
+
+    forward.close();
+
+    if(std::ranges::none_of(complexTypes, [](const ComplexType& type) { return !type.constraints.empty(); })) {
+        return true;
+    }
+
+    std::ofstream source(outputDir + "/Types.cpp");
+    if(!source.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Types.cpp", outputDir);
+        return false;
+    }
+
+    println(source, "#include \"Types.h\"");
+    println(source, "#include <stdexcept>\n");
+
+    if(!namespaceName.empty()) {
+        println(source, "namespace {} {{\n", namespaceName);
+    }
+
+    for(const auto& complexType: complexTypes) {
+        if(!complexType.constraints.empty()) {
+            source << complexType.generateIndexCode(namespaceName, options_);
+        }
+    }
+
+    if(!namespaceName.empty()) {
+        println(source, "}} // namespace {}", namespaceName);
+    }
+
+    source.close();
+    return true;
+}
+
 void Parser::clear() {
     enums.clear();
     complexTypes.clear();
     elements.clear();
+    groups.clear();
+    simpleTypeFacets.clear();
+    identityConstraints.clear();
+    simpleTypes.clear();
+    counters_ = {};
     doc_.Clear();
 }
 #if 0
@@ -406,7 +975,7 @@ void Parser::parseSimpleType(const tinyxml2::XMLElement* element) {
             enumElem = enumElem->NextSiblingElement("xs:enumeration")) {
             const char* value = enumElem->Attribute("value");
             if(value) {
-                enumType.values.push_back(value);
+                enumType.values.emplace_back(value);
             }
         }
 
@@ -418,28 +987,180 @@ void Parser::parseSimpleType(const tinyxml2::XMLElement* element) {
 
                 const char* value = enumElem->Attribute("value");
                 if(value) {
-                    enumType.values.push_back(value);
+                    enumType.values.emplace_back(value);
                 }
             }
         }
 
-        if(enums.size())
-            enums.push_back(enumType);
-        else
-            typeMap.emplace(name, "std::string"sv);
+        if(enumType.values.size()) {
+            enums.push_back(std::move(enumType));
+            return;
+        }
+
+        // Не перечисление: тип поля - базовый тип, ограничения сохраняются как фасеты
+        Facets facets = parseFacets(restriction);
+        facets.name = std::move(enumType.name);
+        auto stored = simpleTypeFacets.emplace(name, std::move(facets)).first;
+
+        const string_view type = (base ? mappedType(base) : std::nullopt).value_or("std::string"sv);
+        simpleTypes.emplace(name, storageType(type, stored->second));
     }
 }
 
+namespace {
+
+// Значение xs:enumeration как литерал шаблона XSD
+string escapePattern(string_view value) {
+    string result;
+    for(char c: value) {
+        if("\\|.-^?*+{}()[]"sv.contains(c)) result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+} // namespace
+
+// Фасеты xs:restriction; фасеты базового простого типа наследуются
+Facets Parser::parseFacets(const tinyxml2::XMLElement* restriction) const {
+    Facets facets;
+    if(const char* base = restriction->Attribute("base")) {
+        facets = facetsOf(base);
+        facets.name.clear();
+    }
+
+    // Шаблоны и значения одного шага объединяются через |, шаги наследования - через «и»
+    vector<string> patterns;
+    vector<string> values;
+    for(const tinyxml2::XMLElement* child = restriction->FirstChildElement();
+        child != nullptr;
+        child = child->NextSiblingElement()) {
+        const char* value = child->Attribute("value");
+        if(!value) continue;
+
+        const string_view facet = child->Name();
+        if(testName(facet, "xs:pattern"sv))
+            patterns.emplace_back(value);
+        else if(testName(facet, "xs:enumeration"sv))
+            values.push_back(escapePattern(value));
+        else if(testName(facet, "xs:length"sv))
+            facets.length = atoi(value);
+        else if(testName(facet, "xs:minLength"sv))
+            facets.minLength = atoi(value);
+        else if(testName(facet, "xs:maxLength"sv))
+            facets.maxLength = atoi(value);
+        else if(testName(facet, "xs:minInclusive"sv))
+            facets.minInclusive = value;
+        else if(testName(facet, "xs:maxInclusive"sv))
+            facets.maxInclusive = value;
+        else if(testName(facet, "xs:minExclusive"sv))
+            facets.minExclusive = value;
+        else if(testName(facet, "xs:maxExclusive"sv))
+            facets.maxExclusive = value;
+    }
+
+    for(auto* step: {&patterns, &values}) {
+        if(step->size() == 1) {
+            facets.patterns.push_back(step->front());
+        } else if(step->size() > 1) {
+            string alternatives;
+            for(const auto& pattern: *step) {
+                alternatives += (alternatives.empty() ? "(" : "|(") + pattern + ")";
+            }
+            facets.patterns.push_back(std::move(alternatives));
+        }
+    }
+
+    return facets;
+}
+
+Facets Parser::facetsOf(string_view xsdType) const {
+    auto it = simpleTypeFacets.find(xsdType);
+    return it != simpleTypeFacets.end() ? it->second : Facets{};
+}
+
+namespace {
+
+// Целые типы C++ по возрастанию размера
+constexpr IntegerType integerTypes[]{
+    {"int8_t",   1, INT8_MIN,  INT8_MAX  },
+    {"uint8_t",  1, 0,         UINT8_MAX },
+    {"int16_t",  2, INT16_MIN, INT16_MAX },
+    {"uint16_t", 2, 0,         UINT16_MAX},
+    {"int32_t",  4, INT32_MIN, INT32_MAX },
+    {"uint32_t", 4, 0,         UINT32_MAX},
+    {"int64_t",  8, INT64_MIN, INT64_MAX },
+    {"uint64_t", 8, 0,         UINT64_MAX},
+};
+
+// Граница фасета как целое; false - граница не помещается в int64_t или не целая
+bool integerBound(const string& text, int64_t& value) {
+    const char* first = text.data() + (text.starts_with('+') ? 1 : 0);
+    auto [end, ec] = std::from_chars(first, text.data() + text.size(), value);
+    return ec == std::errc{} && end == text.data() + text.size();
+}
+
+} // namespace
+
+const IntegerType* IntegerType::find(string_view name) {
+    auto it = std::ranges::find(integerTypes, name, &IntegerType::name);
+    return it != std::end(integerTypes) ? &*it : nullptr;
+}
+
+const IntegerType* IntegerType::narrowest(const IntegerType& base, const Facets& facets) {
+    int64_t low = base.min;
+    int64_t high = base.max > uint64_t{INT64_MAX} ? INT64_MAX : static_cast<int64_t>(base.max);
+    int64_t value{};
+
+    // Исключающие границы сводятся к включающим; пересекаем с диапазоном базового типа
+    if(!facets.minInclusive.empty()) {
+        if(!integerBound(facets.minInclusive, value)) return nullptr;
+        low = std::max(low, value);
+    }
+    if(!facets.minExclusive.empty()) {
+        if(!integerBound(facets.minExclusive, value) || value == INT64_MAX) return nullptr;
+        low = std::max(low, value + 1);
+    }
+    if(!facets.maxInclusive.empty()) {
+        if(!integerBound(facets.maxInclusive, value)) return nullptr;
+        high = std::min(high, value);
+    }
+    if(!facets.maxExclusive.empty()) {
+        if(!integerBound(facets.maxExclusive, value) || value == INT64_MIN) return nullptr;
+        high = std::min(high, value - 1);
+    }
+    if(low > high) return nullptr;
+
+    // При равном размере предпочитается знаковость базового типа
+    const IntegerType* best = nullptr;
+    for(const auto& type: integerTypes) {
+        if(type.size > base.size || !type.fits(low, high)) continue;
+        if(!best || type.size < best->size || (type.size == best->size && (type.min < 0) == (base.min < 0)))
+            best = &type;
+    }
+    return best;
+}
+
+// Тип хранения поля: для целых - самый узкий тип, вмещающий диапазон фасетов
+string_view Parser::storageType(string_view type, const Facets& facets) {
+    const IntegerType* base = IntegerType::find(type);
+    if(!base) return type;
+    const IntegerType* narrow = IntegerType::narrowest(*base, facets);
+    return narrow ? narrow->name : type;
+}
+
 // Обновленный метод parseComplexType с поддержкой complexContent и simpleContent
-void Parser::parseComplexType(const tinyxml2::XMLElement* element) {
+void Parser::parseComplexType(const tinyxml2::XMLElement* element, const string& anonymousName) {
     ComplexType complexType;
 
     // Получаем имя типа
     const char* name = element->Attribute("name");
-    if(!name) {
+    if(!name && !anonymousName.empty()) {
+        // Встроенный тип элемента - имя задано вызывающим
+        complexType.name = anonymousName;
+    } else if(!name) {
         // Анонимный тип - генерируем имя
-        static int anonymousComplexCounter = 0;
-        complexType.name = "AnonymousComplexType_" + std::to_string(anonymousComplexCounter++);
+        complexType.name = "AnonymousComplexType_" + std::to_string(counters_.anonymousComplexType++);
     } else {
         complexType.name = sanitizeName(name);
     }
@@ -484,11 +1205,12 @@ void Parser::parseComplexType(const tinyxml2::XMLElement* element) {
             textField.type = "std::string";
             textField.documentation = "Текстовое содержимое mixed content";
             textField.isAttribute = false;
+            textField.isText = true;
             textField.isOptional = true;
             textField.minOccurs = 0;
             textField.maxOccurs = 1;
 
-            complexType.fields.push_back(textField);
+            complexType.fields.push_back(std::move(textField));
         }
 
         // Парсим содержимое
@@ -522,7 +1244,7 @@ void Parser::parseComplexType(const tinyxml2::XMLElement* element) {
     }
 
     if(!isDuplicate) {
-        complexTypes.push_back(complexType);
+        complexTypes.push_back(std::move(complexType));
     } else {
         std::cout << "  Предупреждение: тип '" << complexType.name
                   << "' уже существует, пропускаем дубликат" << std::endl;
@@ -535,6 +1257,7 @@ void Parser::parseElement(const tinyxml2::XMLElement* element) {
     const char* name = element->Attribute("name");
     if(name) {
         xsdElement.name = sanitizeName(name);
+        xsdElement.xmlName = name;
     }
 
     const char* type = element->Attribute("type");
@@ -546,11 +1269,25 @@ void Parser::parseElement(const tinyxml2::XMLElement* element) {
         if(xsdElement.type.find(":") != std::string::npos) {
             xsdElement.isComplex = true;
         }
+    } else if(name) {
+        // Встроенный complexType корневого элемента получает имя элемента
+        const tinyxml2::XMLElement* complexTypeElem = element->FirstChildElement("xs:complexType");
+        if(!complexTypeElem) complexTypeElem = element->FirstChildElement("complexType");
+
+        if(complexTypeElem) {
+            parseComplexType(complexTypeElem, xsdElement.name);
+            xsdElement.type = xsdElement.name;
+            xsdElement.isComplex = true;
+        }
     }
 
     xsdElement.documentation = getDocumentation(element);
 
-    elements.push_back(xsdElement);
+    if(!xsdElement.type.empty()) {
+        parseIdentityConstraints(element, type ? convertXsdTypeToCpp(type) : xsdElement.type);
+    }
+
+    elements.push_back(std::move(xsdElement));
 }
 
 string normalize(string str) {
@@ -564,14 +1301,31 @@ string normalize(string str) {
 }
 
 // Реализация методов генерации кода для Enum
-string Enum::generateHeaderCode() const {
+string Enum::generateConversionDecl() const {
+    std::stringstream ss;
+
+    if(values.size()) {
+        // Функции преобразования
+        println(ss, "// Функции преобразования для {}", name);
+        println(ss, "template <> {0} stringTo<{0}>(const std::string& str);", name);
+        println(ss, "std::string toString({} value);\n", name);
+    }
+
+    return ss.str();
+}
+
+string Enum::generateHeaderCode(bool conversions) const {
     std::stringstream ss;
 
     if(!documentation.empty()) {
         println(ss, "/*\n{}\n*/", documentation);
     }
 
-    println(ss, "enum class {} {{", name);
+    // Базовый тип задаётся явно: uint8_t вместо int сокращает структуры с перечислениями
+    if(const auto underlying = underlyingType(); !underlying.empty())
+        println(ss, "enum class {} : {} {{", name, underlying);
+    else
+        println(ss, "enum class {} {{", name);
 
     for(auto&& value: values)
         if(auto norm = normalize(value); norm != value)
@@ -581,11 +1335,8 @@ string Enum::generateHeaderCode() const {
 
     println(ss, "}};\n");
 
-    if(values.size()) {
-        // Функции преобразования
-        println(ss, "// Функции преобразования для {}", name);
-        println(ss, "extern template {0} stringTo<{0}>(const std::string& str);", name);
-        println(ss, "std::string toString({} value);\n", name);
+    if(conversions) {
+        ss << generateConversionDecl();
     }
 
     return ss.str();
@@ -597,7 +1348,7 @@ string Enum::generateSourceCode() const {
     if(values.empty()) return {};
 
     // stringToEnum
-    println(ss, "template<{0}> {0} stringTo(const std::string& str) {{", name);
+    println(ss, "template <> {0} stringTo<{0}>(const std::string& str) {{", name);
     println(ss, "    static const std::map<std::string, {}> mapping = {{", name);
 
     for(const auto& value: values)
@@ -627,8 +1378,34 @@ string Enum::generateSourceCode() const {
     return ss.str();
 }
 
+// Преобразование без исключений: пары (текст, значение) упорядочены по тексту для двоичного поиска
+string Enum::generateTryConversion() const {
+    std::stringstream ss;
+
+    if(values.empty()) return {};
+
+    std::map<string, string> mapping;
+    for(const auto& value: values) {
+        mapping.emplace(normalize(value), normalize(value));
+        mapping.emplace(value, normalize(value));
+    }
+
+    println(ss, "template <> std::expected<{0}, ValueError> tryStringTo<{0}>(std::string_view text) {{", name);
+    println(ss, "    using Entry = std::pair<std::string_view, {}>;", name);
+    println(ss, "    static constexpr Entry mapping[]{{");
+    for(const auto& [text, value]: mapping)
+        println(ss, "        {{\"{}\", {}::{}}},", text, name, value);
+    println(ss, "    }};\n");
+    println(ss, "    auto it = std::ranges::lower_bound(mapping, text, {{}}, &Entry::first);");
+    println(ss, "    if(it != std::end(mapping) && it->first == text) return it->second;");
+    println(ss, "    return std::unexpected{{ValueError::Invalid}};");
+    println(ss, "}}\n");
+
+    return ss.str();
+}
+
 // Реализация методов генерации кода для ComplexType
-string ComplexType::generateHeaderCode() const {
+string ComplexType::generateHeaderCode(const string& namespaceName, const Options& options) const {
     std::stringstream ss;
 
     if(!documentation.empty()) {
@@ -638,15 +1415,28 @@ string ComplexType::generateHeaderCode() const {
     println(ss, "struct {} {{", name);
 
     // Поля
-    for(const auto& field: fields) {
+    for(size_t i = 0; i < fields.size(); ++i) {
+        const Field& field = fields[memberOrder.empty() ? i : memberOrder[i]];
         if(!field.documentation.empty()) {
             println(ss, "    // {}", field.documentation);
         }
 
         string type = field.type;
 
+        // Имя поля совпадает с именем типа - квалифицируем тип,
+        // иначе объявление поля меняет смысл имени внутри структуры
+        if((field.kind == Field::Kind::Complex || field.kind == Field::Kind::Enum)
+            && std::ranges::any_of(fields, [&](const Field& other) { return other.name == field.type; })) {
+            type = (namespaceName.empty() ? "::" : "::" + namespaceName + "::") + type;
+        }
+
         // Если поле может встречаться много раз
-        if(field.maxOccurs == -1 || field.maxOccurs > 1) {
+        if(field.isShared) {
+            type = "Shared<" + type + ">";
+        }
+        if(options.isLazy(field)) {
+            type = "Lazy<" + type + ">";
+        } else if(field.maxOccurs == -1 || field.maxOccurs > 1) {
             type = "std::vector<" + type + ">";
         }
 
@@ -661,6 +1451,14 @@ string ComplexType::generateHeaderCode() const {
         println(ss, "    {} {};", type, field.name);
     }
 
+    if(!constraints.empty()) {
+        ss << generateIndexDecl(namespaceName, options);
+    }
+
+    if(options.comparisons) {
+        ss << generateComparisonDecl(namespaceName);
+    }
+
     // println(ss, "\n    // Конструкторы");
     // println(ss, "    {}() = default;", name);
     // println(ss, "    ~{}() = default;\n", name);
@@ -672,11 +1470,6 @@ string ComplexType::generateHeaderCode() const {
     // println(ss, "    static {} fromXmlNode(const tinyxml2::XMLElement* element);", name);
     // println(ss, "    tinyxml2::XMLElement* toXmlNode(tinyxml2::XMLDocument& doc) const;\n", name);
 
-    // Операторы сравнения
-    // println(ss, "    // Операторы сравнения");
-    // println(ss, "    bool operator==(const {}& other) const;", name);
-    // println(ss, "    bool operator!=(const {}& other) const;", name);
-
     println(ss, "}};\n");
 
     return ss.str();
@@ -856,6 +1649,15 @@ std::string ComplexType::generateSourceCode() const {
 #endif
 
 void Parser::parseSchema(const tinyxml2::XMLElement* schemaElement) {
+    // Группы могут использоваться до своего определения - собираем их заранее
+    for(const tinyxml2::XMLElement* child = schemaElement->FirstChildElement();
+        child != nullptr;
+        child = child->NextSiblingElement()) {
+        if(const char* name = child->Attribute("name"); name && testName(child->Name(), "xs:group"sv)) {
+            groups.emplace(name, child);
+        }
+    }
+
     // Парсим все дочерние элементы
     for(const tinyxml2::XMLElement* child = schemaElement->FirstChildElement();
         child != nullptr;
@@ -889,34 +1691,70 @@ string Parser::getDocumentation(const tinyxml2::XMLElement* element) const {
     return "";
 }
 
-string Parser::convertXsdTypeToCpp(const string& xsdType) const {
+// Определяем категорию типа каждого поля после того, как известны все типы схемы
+void Parser::resolveFieldKinds() {
+    auto isBuiltIn = [this](const string& type) {
+        auto stores = [&](const auto& entry) { return entry.second == type; };
+        return std::ranges::any_of(typeMap, stores) || std::ranges::any_of(simpleTypes, stores);
+    };
+    auto isEnum = [this](const string& type) {
+        return std::ranges::any_of(enums, [&](const Enum& e) { return e.name == type; });
+    };
+
+    for(auto& complexType: complexTypes) {
+        for(auto& field: complexType.fields) {
+            if(field.type == "std::string") {
+                field.kind = Field::Kind::String;
+                // Ограниченная строка хранится в самом объекте: ёмкость в байтах UTF-8 - до 4 байт на символ
+                const int bound = field.facets.length >= 0 ? field.facets.length : field.facets.maxLength;
+                if(bound > 0 && bound <= options_.inlineStrings)
+                    field.type = std::format("FixedString<{}>", bound * 4);
+            } else if(field.type == "std::vector<unsigned char>")
+                field.kind = Field::Kind::Binary;
+            else if(isBuiltIn(field.type))
+                field.kind = Field::Kind::Scalar;
+            else if(isEnum(field.type))
+                field.kind = Field::Kind::Enum;
+            else
+                field.kind = Field::Kind::Complex;
+        }
+    }
+}
+
+// Тип хранения встроенного типа XSD или именованного простого типа схемы
+std::optional<string_view> Parser::mappedType(string_view xsdType) const {
+    if(auto it = typeMap.find(xsdType); it != typeMap.end()) return it->second;
+    if(auto it = simpleTypes.find(xsdType); it != simpleTypes.end()) return it->second;
+    return std::nullopt;
+}
+
+string Parser::convertXsdTypeToCpp(string_view xsdType) const {
     // Проверяем в карте типов
-    auto it = typeMap.find(xsdType);
-    if(it != typeMap.end()) {
-        return string{it->second};
+    if(auto type = mappedType(xsdType)) {
+        return string{*type};
     }
 
     // Если тип не найден, проверяем, является ли он пользовательским типом
     // Удаляем префикс пространства имен, если есть
-    size_t colonPos = xsdType.find(":");
-    string typeName = (colonPos != std::string::npos) ? xsdType.substr(colonPos + 1) : xsdType;
+    size_t colonPos = xsdType.find(':');
+    const string_view typeName = (colonPos != string_view::npos) ? xsdType.substr(colonPos + 1) : xsdType;
 
     // Проверяем, является ли это перечислением
     for(const auto& enumType: enums) {
         if(enumType.name == typeName) {
-            return typeName;
+            return enumType.name;
         }
     }
 
     // Проверяем, является ли это complexType
     for(const auto& complexType: complexTypes) {
         if(complexType.name == typeName) {
-            return typeName;
+            return complexType.name;
         }
     }
 
     // Если не нашли, возвращаем как есть (будет сгенерирован класс)
-    return sanitizeName(typeName);
+    return sanitizeName(string{typeName});
 }
 
 string Parser::sanitizeName(string name) {
@@ -935,6 +1773,7 @@ string Parser::sanitizeName(string name) {
 
 string Parser::toCamelCase(const string& str) {
     string result;
+    result.reserve(str.size());
     bool makeUpper = true;
 
     for(char c: str) {
@@ -959,12 +1798,12 @@ string Parser::toUpperCase(string str) {
 /////////////////////////////////////////////////////////////////////
 
 // Вспомогательные функции
-string Parser::trim(const string& str) {
+string Parser::trim(string_view str) {
     size_t first = str.find_first_not_of(" \t\n\r");
-    if(first == std::string::npos) return "";
+    if(first == string_view::npos) return "";
 
     size_t last = str.find_last_not_of(" \t\n\r");
-    return str.substr(first, (last - first + 1));
+    return string{str.substr(first, (last - first + 1))};
 }
 
 // Обновленный метод parseAttributes
@@ -985,6 +1824,7 @@ void Parser::parseAttributes(const tinyxml2::XMLElement* element, ComplexType& c
             const char* name = child->Attribute("name");
             if(name) {
                 field.name = sanitizeName(name);
+                field.xmlName = name;
             } else {
                 continue; // Пропускаем атрибуты без имени
             }
@@ -993,6 +1833,7 @@ void Parser::parseAttributes(const tinyxml2::XMLElement* element, ComplexType& c
             const char* type = child->Attribute("type");
             if(type) {
                 field.type = convertXsdTypeToCpp(type);
+                field.facets = facetsOf(type);
             } else {
                 // Проверяем встроенный тип
                 const tinyxml2::XMLElement* simpleType = child->FirstChildElement("xs:simpleType");
@@ -1003,9 +1844,10 @@ void Parser::parseAttributes(const tinyxml2::XMLElement* element, ComplexType& c
                     if(!restriction) restriction = simpleType->FirstChildElement("restriction");
 
                     if(restriction) {
+                        field.facets = parseFacets(restriction);
                         const char* base = restriction->Attribute("base");
                         if(base) {
-                            field.type = convertXsdTypeToCpp(base);
+                            field.type = storageType(convertXsdTypeToCpp(base), field.facets);
                         } else {
                             field.type = "std::string";
                         }
@@ -1058,7 +1900,7 @@ void Parser::parseAttributes(const tinyxml2::XMLElement* element, ComplexType& c
                 field.documentation += "[Фиксированное значение: " + std::string(fixedValue) + "]";
             }
 
-            complexType.fields.push_back(field);
+            complexType.fields.push_back(std::move(field));
         }
         // Обработка групп атрибутов
         else if(childName && (testName(childName, "xs:attributeGroup"sv))) {
@@ -1077,18 +1919,23 @@ void Parser::parseSequenceElements(const tinyxml2::XMLElement* sequence,
 
     if(!sequence) return;
 
+    // Место под все поля последовательности сразу: Field перемещаются, но без переаллокаций
+    size_t count = 0;
+    for(auto* child = sequence->FirstChildElement(); child; child = child->NextSiblingElement()) ++count;
+    complexType.fields.reserve(complexType.fields.size() + count);
+
     // Обрабатываем все дочерние элементы sequence
     for(const tinyxml2::XMLElement* child = sequence->FirstChildElement();
         child != nullptr;
         child = child->NextSiblingElement()) {
 
         const char* childName = child->Name();
-        string elementName = childName ? childName : "";
+        const string_view elementName = childName ? childName : "";
 
         if(testName(elementName, "xs:element"sv)) { // Элемент
             Field field;
             parseElementDetails(child, field);
-            if(!field.name.empty()) complexType.fields.push_back(field);
+            if(!field.name.empty()) complexType.fields.push_back(std::move(field));
         } else if(testName(elementName, "xs:group"sv)) { // Группа элементов
             parseGroupReference(child, complexType);
         } else if(testName(elementName, "xs:sequence"sv)) { // Последовательность внутри последовательности (вложенная)
@@ -1114,15 +1961,29 @@ void Parser::parseChoiceElements(const tinyxml2::XMLElement* choice,
 
     std::cout << "  Предупреждение: элемент <choice> требует ручной обработки" << std::endl;
 
+    // Повторяющийся choice (maxOccurs > 1) допускает любое число каждого варианта
+    const char* choiceMaxOccurs = choice->Attribute("maxOccurs");
+    const bool isRepeated = choiceMaxOccurs
+        && (choiceMaxOccurs == "unbounded"sv || atoi(choiceMaxOccurs) > 1);
+
     // Временная реализация - обрабатываем как последовательность
     for(const tinyxml2::XMLElement* child = choice->FirstChildElement();
         child != nullptr;
         child = child->NextSiblingElement()) {
 
         const char* childName = child->Name();
-        string elementName = childName ? childName : "";
+        const string_view elementName = childName ? childName : "";
 
-        if(testName(elementName, "xs:element")) {
+        if(testName(elementName, "xs:group")) {
+            // Группа внутри choice - все её элементы становятся опциональными
+            size_t first = complexType.fields.size();
+            parseGroupReference(child, complexType);
+            for(size_t i = first; i < complexType.fields.size(); ++i) {
+                complexType.fields[i].isOptional = true;
+                complexType.fields[i].minOccurs = 0;
+                if(isRepeated) complexType.fields[i].maxOccurs = -1;
+            }
+        } else if(testName(elementName, "xs:element")) {
             Field field;
             field.isAttribute = false;
 
@@ -1131,10 +1992,10 @@ void Parser::parseChoiceElements(const tinyxml2::XMLElement* choice,
             // Для choice отмечаем поле как опциональное
             field.isOptional = true;
             field.minOccurs = 0;
-            field.maxOccurs = 1;
+            if(isRepeated) field.maxOccurs = -1;
 
             if(!field.name.empty()) {
-                complexType.fields.push_back(field);
+                complexType.fields.push_back(std::move(field));
             }
         }
     }
@@ -1153,7 +2014,7 @@ void Parser::parseAllElements(const tinyxml2::XMLElement* all,
         child = child->NextSiblingElement()) {
 
         const char* childName = child->Name();
-        string elementName = childName ? childName : "";
+        const string_view elementName = childName ? childName : "";
 
         if(testName(elementName, "xs:element")) {
             Field field;
@@ -1171,7 +2032,7 @@ void Parser::parseAllElements(const tinyxml2::XMLElement* all,
             field.maxOccurs = 1;
 
             if(!field.name.empty()) {
-                complexType.fields.push_back(field);
+                complexType.fields.push_back(std::move(field));
             }
         }
     }
@@ -1188,10 +2049,35 @@ void Parser::parseGroupReference(const tinyxml2::XMLElement* groupRef,
         return;
     }
 
-    println(std::cout, "  Информация: ссылка на группу '{}' - группы требуют предварительного определения", refName);
+    auto it = groups.find(extractLocalName(refName));
+    if(it == groups.end()) {
+        println(std::cerr, "  Ошибка: группа '{}' не определена", refName);
+        return;
+    }
 
-    // В полной реализации здесь нужно найти определение группы
-    // и добавить все её элементы в complexType
+    // Подставляем содержимое группы на место ссылки
+    size_t first = complexType.fields.size();
+    for(const tinyxml2::XMLElement* child = it->second->FirstChildElement();
+        child != nullptr;
+        child = child->NextSiblingElement()) {
+        const char* childName = child->Name();
+        if(testName(childName, "xs:sequence"sv)) {
+            parseSequenceElements(child, complexType);
+        } else if(testName(childName, "xs:choice"sv)) {
+            parseChoiceElements(child, complexType);
+        } else if(testName(childName, "xs:all"sv)) {
+            parseAllElements(child, complexType);
+        }
+    }
+
+    // Необязательная ссылка (minOccurs="0") делает необязательными все элементы группы
+    const char* minOccurs = groupRef->Attribute("minOccurs");
+    if(minOccurs && atoi(minOccurs) == 0) {
+        for(size_t i = first; i < complexType.fields.size(); ++i) {
+            complexType.fields[i].isOptional = true;
+            complexType.fields[i].minOccurs = 0;
+        }
+    }
 }
 
 void Parser::parseElementDetails(const tinyxml2::XMLElement* elementNode,
@@ -1201,17 +2087,18 @@ void Parser::parseElementDetails(const tinyxml2::XMLElement* elementNode,
     const char* name = elementNode->Attribute("name");
     if(name) {
         field.name = sanitizeName(name);
+        field.xmlName = name;
     } else {
         // Элемент может быть анонимным (inline type)
         // Генерируем уникальное имя
-        static int anonymousCounter = 0;
-        field.name = "anonymousElement_" + std::to_string(anonymousCounter++);
+        field.name = "anonymousElement_" + std::to_string(counters_.anonymousElement++);
     }
 
     // Получаем тип элемента
     const char* typeAttr = elementNode->Attribute("type");
     if(typeAttr) {
         field.type = convertXsdTypeToCpp(typeAttr);
+        field.facets = facetsOf(typeAttr);
     } else {
         // Проверяем встроенный тип
         const tinyxml2::XMLElement* simpleType = elementNode->FirstChildElement("xs:simpleType");
@@ -1228,23 +2115,19 @@ void Parser::parseElementDetails(const tinyxml2::XMLElement* elementNode,
             if(!restriction) restriction = simpleType->FirstChildElement("restriction");
 
             if(restriction) {
+                field.facets = parseFacets(restriction);
                 const char* base = restriction->Attribute("base");
                 if(base) {
-                    field.type = convertXsdTypeToCpp(base);
+                    field.type = storageType(convertXsdTypeToCpp(base), field.facets);
                 }
             }
         } else if(complexTypeElem) {
             // Обрабатываем встроенный сложный тип
             // Генерируем уникальное имя для типа
-            static int inlineTypeCounter = 0;
-            string inlineTypeName = field.name + "_t" + std::to_string(inlineTypeCounter++);
-
-            // Создаем временный complexType
-            ComplexType inlineType;
-            inlineType.name = inlineTypeName;
+            string inlineTypeName = field.name + "_t" + std::to_string(counters_.inlineType++);
 
-            // Рекурсивно парсим встроенный тип
-            parseComplexType(complexTypeElem);
+            // Рекурсивно парсим встроенный тип под сгенерированным именем
+            parseComplexType(complexTypeElem, inlineTypeName);
 
             field.type = inlineTypeName;
         } else {
@@ -1303,6 +2186,9 @@ void Parser::parseElementDetails(const tinyxml2::XMLElement* elementNode,
         field.isOptional = true;
         field.minOccurs = 0;
     }
+
+    // xs:key/xs:unique/xs:keyref относятся к типу элемента
+    parseIdentityConstraints(elementNode, field.type);
 }
 
 void Parser::handleComplexContent(const tinyxml2::XMLElement* complexContent,
@@ -1360,13 +2246,15 @@ void Parser::handleSimpleContent(const tinyxml2::XMLElement* simpleContent,
             Field textField;
             textField.name = "value";
             textField.type = convertXsdTypeToCpp(base);
+            textField.facets = facetsOf(base);
             textField.documentation = "Текстовое значение элемента";
             textField.isAttribute = false;
+            textField.isText = true;
             textField.isOptional = false;
             textField.minOccurs = 1;
             textField.maxOccurs = 1;
 
-            complexType.fields.push_back(textField);
+            complexType.fields.push_back(std::move(textField));
         }
 
         // Обрабатываем атрибуты
@@ -1382,14 +2270,16 @@ void Parser::handleSimpleContent(const tinyxml2::XMLElement* simpleContent,
         if(base) {
             Field textField;
             textField.name = "value";
-            textField.type = convertXsdTypeToCpp(base);
+            textField.facets = parseFacets(restriction);
+            textField.type = storageType(convertXsdTypeToCpp(base), textField.facets);
             textField.documentation = "Текстовое значение элемента с ограничениями";
             textField.isAttribute = false;
+            textField.isText = true;
             textField.isOptional = false;
             textField.minOccurs = 1;
             textField.maxOccurs = 1;
 
-            complexType.fields.push_back(textField);
+            complexType.fields.push_back(std::move(textField));
         }
     }
 }
@@ -1,9 +1,12 @@
 #pragma once
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <fstream>
 #include <map>
 #include <memory>
+#include <optional>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -30,20 +33,171 @@ struct Enum {
     vector<string> values;
     string baseType; // Базовый тип (string, int и т.д.)
 
+    // Самый узкий базовый тип enum class по числу значений
+    string_view underlyingType() const {
+        return values.size() <= 256 ? "std::uint8_t"sv : values.size() <= 65536 ? "std::uint16_t"sv : ""sv;
+    }
+
     // Генерация C++ кода для перечисления
-    string generateHeaderCode() const;
+    string generateHeaderCode(bool conversions = true) const;
+    string generateConversionDecl() const;
     string generateSourceCode() const;
+    string generateTryConversion() const; // tryStringTo без исключений (Expected.cpp)
+    string generateLiteralCode() const;   // Значение как выражение C++ (Embed.cpp)
+};
+
+// Имя перечислителя C++ для значения xs:enumeration
+string normalize(string str);
+
+// Фасеты xs:restriction простого типа
+struct Facets {
+    string name;             // Простой тип; пусто - ограничение встроено в поле
+    vector<string> patterns; // xs:pattern/xs:enumeration по шагам наследования: значение соответствует каждому
+    int length{-1};          // xs:length в символах (для двоичных данных - в байтах), -1 - не задано
+    int minLength{-1};
+    int maxLength{-1};
+    string minInclusive; // Границы в лексической форме XSD, пусто - не задано
+    string maxInclusive;
+    string minExclusive;
+    string maxExclusive;
+
+    bool empty() const {
+        return patterns.empty() && length < 0 && minLength < 0 && maxLength < 0
+            && minInclusive.empty() && maxInclusive.empty() && minExclusive.empty() && maxExclusive.empty();
+    }
+};
+
+// Случайные строки, удовлетворяющие фасетам (шаблоны, длина); автоматы шаблонов
+// строятся при первом обращении и переиспользуются (XsdValidate.cpp)
+class StringSampler {
+public:
+    StringSampler();
+    ~StringSampler();
+
+    // nullopt - подходящую строку найти не удалось
+    std::optional<string> sample(const Facets& facets, std::mt19937_64& random);
+
+private:
+    struct Automaton;
+    const Automaton* automaton(const string& pattern); // nullptr - шаблон не поддерживается
+
+    std::map<string, std::unique_ptr<Automaton>> automata_;
+};
+
+// Целый тип C++ и его диапазон: выбор хранения по фасетам диапазона
+struct IntegerType {
+    string_view name;
+    int size;
+    int64_t min;
+    uint64_t max;
+
+    bool fits(int64_t low, int64_t high) const {
+        return min <= low && (high < 0 || static_cast<uint64_t>(high) <= max);
+    }
+
+    static const IntegerType* find(string_view name);
+    // Самый узкий тип не шире base, вмещающий границы facets; nullptr - границы не заданы или не целые
+    static const IntegerType* narrowest(const IntegerType& base, const Facets& facets);
 };
 
 // Структура для представления поля в complexType
 struct Field {
+    // Категория C++ типа поля (определяет способ сериализации)
+    enum class Kind {
+        String,  // std::string, FixedString<N> или PooledString
+        Scalar,  // bool, целые и вещественные числа
+        Binary,  // std::vector<unsigned char>
+        Enum,    // Сгенерированное перечисление
+        Complex, // Сгенерированная структура
+    };
+
     string name;
+    string xmlName; // Исходное имя элемента/атрибута в XML
     string type;
     string documentation;
     bool isOptional{false};
     int minOccurs{1};
     int maxOccurs{1};        // -1 означает unbounded
     bool isAttribute{false}; // Является ли атрибутом
+    bool isText{false};      // Текстовое содержимое (simpleContent/mixed)
+    bool isShared{false};    // Элементы коллекции - разделяемые поддеревья Shared<T> (Options::intern)
+    Kind kind{Kind::String};
+    Facets facets; // Ограничения значения (Validate.h)
+
+    bool isRepeated() const { return maxOccurs == -1 || maxOccurs > 1; }
+};
+
+// Ограничение идентичности xs:key / xs:unique / xs:keyref
+struct IdentityConstraint {
+    enum class Kind {
+        Key,    // Значение обязательно и уникально
+        Unique, // Значение уникально, если присутствует
+        KeyRef, // Ссылка на значение xs:key/xs:unique
+    };
+
+    Kind kind{Kind::Key};
+    string name;     // Имя ограничения (идентификатор C++)
+    string selector; // XPath выборки элементов
+    string field;    // XPath поля внутри выбранного элемента
+    string refer;    // Для keyref: имя ограничения, на которое ссылаются
+
+    // Заполняется в Parser::resolveIdentityConstraints()
+    vector<Field> path; // Цепочка полей от владельца до коллекции (последнее - повторяющееся)
+    Field key;          // Поле ключа в элементе коллекции
+};
+
+// Параметры генерации кода
+struct Options {
+    // Неограниченные коллекции вложенных структур декодируются при первом обращении (Lazy<T>)
+    bool lazyCollections{false};
+    // Большие коллекции вложенных структур загружаются параллельно (LoadPool)
+    bool parallelCollections{false};
+    // Таблицы описаний полей (Descriptors.h) и обобщённые загрузка/сериализация по ним
+    bool descriptors{false};
+    // Лёгкие заголовки: Types.h без tinyxml2, преобразования перечислений в Enums_io.h,
+    // предварительные объявления в Types_fwd.h, определения - в одной единице трансляции
+    bool leanHeaders{false};
+    // Интерфейс модуля C++20 (Generated.cppm) и сборка через FILE_SET CXX_MODULES
+    bool modules{false};
+    // Разделы модуля по группам заголовков: :Types, :Reader, :Writer, :Binary, :Validate
+    bool modulePartitions{false};
+    // Строки с xs:length/xs:maxLength не больше порога хранятся в FixedString<N> без кучи; 0 - выключено
+    int inlineStrings{0};
+    // Поля в Types.h объявляются по убыванию выравнивания (меньше дополнения); порядок сериализации не меняется
+    bool reorderMembers{false};
+    // Программа замера xsd_generated_bench (Bench.cpp): загрузка, проверка, сериализация экземпляров
+    bool bench{false};
+    // Потоковая загрузка записей - повторяющихся элементов - по мере чтения входа (Stream.h: forEachRecord, readRecords при наличии std::generator)
+    bool streaming{false};
+    // Пакетная загрузка множества файлов: чтение группами через io_uring, разбор на потоках (Batch.h)
+    bool batch{false};
+    // Структурные хеш и равенство структур: hashValue/equalValue (Hash.cpp)
+    bool structuralHash{false};
+    // Элементы коллекций структур - Shared<T>; loadInterned разделяет одинаковые поддеревья
+    bool intern{false};
+    // Строковые поля с повторяющимися значениями - PooledString из пула строк документа:
+    // имена полей (имя XML или Тип.поле) и образец XML, по которому поля выбираются автоматически
+    vector<string> pooledStrings;
+    string pooledStringsSample;
+    // Загрузчики и преобразования без исключений: std::expected с путём и строкой ошибки (Expected.h)
+    bool expected{false};
+    // Операторы сравнения ==/<=> структур и специализации std::hash по hashValue (Hash.cpp)
+    bool comparisons{false};
+    // Встраивание экземпляров: xsd_generated_embed пишет документ constexpr-значением типов Literal.h
+    bool embed{false};
+    // Учёт памяти при загрузке по типам и путям полей, memoryReport() (Memory.h, XSD_GENERATED_MEMORY_REPORT)
+    bool memoryReport{false};
+    // Трассировка загрузки по элементам в формате Chrome trace, traceJson() (Trace.h, XSD_GENERATED_TRACE)
+    bool trace{false};
+
+    bool isLazy(const Field& field) const {
+        return lazyCollections && field.maxOccurs == -1 && field.kind == Field::Kind::Complex;
+    }
+    bool hasHash() const { return structuralHash || intern; }
+    bool isPooling() const { return !pooledStrings.empty() || !pooledStringsSample.empty(); }
+    bool isParallel(const Field& field) const {
+        return parallelCollections && !isLazy(field) && field.isRepeated() && field.kind == Field::Kind::Complex;
+    }
 };
 
 // Структура для представления XSD complexType
@@ -54,15 +208,55 @@ struct ComplexType {
     vector<ComplexType> complexTypes_;
     string baseType; // Наследование
     bool isAbstract{false};
+    vector<IdentityConstraint> constraints; // Ограничения элемента, тип которого - эта структура
+    vector<size_t> memberOrder;             // Порядок объявления fields в Types.h; пусто - порядок схемы
+    string ordering;                        // Тип результата operator<=>; пусто - не генерируется (Options::comparisons)
+    bool isRecursive{false};                // Содержит себя через вложенные структуры (Options::comparisons)
 
     // Генерация C++ кода для структуры
-    string generateHeaderCode() const;
+    string generateHeaderCode(const string& namespaceName = "", const Options& options = {}) const;
     string generateSourceCode() const;
+
+    // Генерация потоковой сериализации (Writer.h/Writer.cpp)
+    string generateWriterDecl() const;
+    string generateWriterCode(const Options& options = {}) const;
+
+    // Генерация загрузки из DOM tinyxml2 (Reader.h/Reader.cpp)
+    string generateReaderDecl() const;
+    string generateReaderCode(const Options& options = {}) const;
+
+    // Генерация бинарного формата (Binary.h/Binary.cpp)
+    string generateBinaryView(const string& namespaceName = "") const;
+    string generateBinaryAccessors(const string& namespaceName = "") const;
+    string generateBinaryCode() const;
+
+    // Генерация индексов xs:key/xs:unique/xs:keyref (Types.h)
+    string generateIndexDecl(const string& namespaceName, const Options& options) const;
+    string generateIndexCode(const string& namespaceName, const Options& options) const;
+
+    // Генерация операторов сравнения (Types.h)
+    string generateComparisonDecl(const string& namespaceName) const;
+
+    // Генерация таблицы описаний полей (Descriptors.h)
+    string generateDescriptor(const string& namespaceName) const;
+
+    // Генерация встраивания экземпляров (Literal.h/Embed.cpp)
+    string generateLiteralDecl(const string& namespaceName) const;
+    string generateLiteralCode() const;
+
+    // Генерация загрузки без исключений (Expected.h/Expected.cpp)
+    string generateExpectedDecl() const;
+    string generateExpectedCode() const;
+
+    // Генерация проверки фасетов (Validate.h/Validate.cpp)
+    string generateValidateDecl() const;
+    string generateValidateCode(const std::map<string, bool>& needsValidation) const;
 };
 
 // Структура для представления XSD элемента
 struct Element {
     string name;
+    string xmlName; // Исходное имя элемента в XML
     string type;
     string documentation;
     bool isComplex{false};
@@ -78,6 +272,10 @@ public:
     bool parse(const string& filename);
     bool generateCppCode(const string& outputDir, const string& namespaceName = "");
 
+    // Параметры генерации
+    void setOptions(const Options& options) { options_ = options; }
+    const Options& getOptions() const { return options_; }
+
     // Геттеры
     const vector<Enum>& getEnums() const { return enums; }
     const vector<ComplexType>& getComplexTypes() const { return complexTypes; }
@@ -86,6 +284,12 @@ public:
     // Вспомогательные методы
     void clear();
     void printSummary() const;
+    void printLayoutReport() const; // sizeof, выравнивание и дополнение структур (XsdLayout.cpp)
+
+    // Синтетический экземпляр схемы около size байт (XsdInstance.cpp): пишется потоком, содержимое задаёт seed
+    bool generateInstance(const string& path, uint64_t size, uint64_t seed = 0) const;
+    // Первый глобальный элемент со сгенерированной структурой (корень документа); nullptr - нет
+    const Element* rootElement() const;
 
 private:
     // Данные
@@ -93,12 +297,28 @@ private:
     vector<Enum> enums;
     vector<ComplexType> complexTypes;
     vector<Element> elements;
-    /*inline static const*/ std::map<string, string_view> typeMap{
+    std::map<string, const tinyxml2::XMLElement*> groups; // Определения xs:group по имени
+    std::map<string, Facets, std::less<>> simpleTypeFacets; // Фасеты именованных простых типов (не перечислений)
+    vector<std::pair<string, IdentityConstraint>> identityConstraints; // Тип-владелец и ограничение до разрешения
+    Options options_;
+    // Именованные простые типы схемы (не перечисления): тип хранения C++ по имени XSD
+    std::map<string, string_view, std::less<>> simpleTypes;
+    // Счётчики имён анонимных типов и элементов: имена зависят только от разбираемой схемы
+    struct NameCounters {
+        int anonymousComplexType{0};
+        int anonymousElement{0};
+        int inlineType{0};
+    } counters_;
+    // Встроенные типы XSD, общие для всех экземпляров Parser и неизменяемые: разбор
+    // нескольких схем на разных потоках не требует синхронизации.
+    // Прозрачное сравнение: поиск по const char* и string_view без временной строки
+    inline static const std::map<string, string_view, std::less<>> typeMap{
         {"xs:string",                "std::string"sv               }, // Для преобразования XSD типов в C++
         {"xs:int",                   "int32_t"sv                   },
         {"xs:integer",               "int32_t"sv                   },
         {"xs:long",                  "int64_t"sv                   },
         {"xs:short",                 "int16_t"sv                   },
+        {"xs:byte",                  "int8_t"sv                    },
         {"xs:decimal",               "double"sv                    },
         {"xs:float",                 "float"sv                     },
         {"xs:double",                "double"sv                    },
@@ -110,11 +330,14 @@ private:
         {"xs:hexBinary",             "std::vector<unsigned char>"sv},
         {"xs:anyURI",                "std::string"sv               },
         {"xs:QName",                 "std::string"sv               },
+        {"xs:Name",                  "std::string"sv               },
+        {"xs:NCName",                "std::string"sv               },
         {"xs:normalizedString",      "std::string"sv               },
         {"xs:token",                 "std::string"sv               },
         {"xs:unsignedInt",           "uint32_t"sv                  },
         {"xs:unsignedLong",          "uint64_t"sv                  },
         {"xs:unsignedShort",         "uint16_t"sv                  },
+        {"xs:unsignedByte",          "uint8_t"sv                   },
         {"xs:positiveInteger",       "uint32_t"sv                  },
         {"xs:nonNegativeInteger",    "uint32_t"sv                  },
         {"scaledNonNegativeInteger", "uint32_t"sv                  },
@@ -125,16 +348,50 @@ private:
 
     // Приватные методы парсинга
     void parseSimpleType(const tinyxml2::XMLElement* element);
-    void parseComplexType(const tinyxml2::XMLElement* element);
+    void parseComplexType(const tinyxml2::XMLElement* element, const string& anonymousName = "");
     void parseElement(const tinyxml2::XMLElement* element);
     void parseSchema(const tinyxml2::XMLElement* schemaElement);
 
     // Вспомогательные методы
     string getDocumentation(const tinyxml2::XMLElement* element) const;
-    string convertXsdTypeToCpp(const string& xsdType) const;
+    void resolveFieldKinds();
+    void parseIdentityConstraints(const tinyxml2::XMLElement* element, const string& ownerType);
+    void resolveIdentityConstraints();
+    void reorderMembers();
+    void markSharedFields();
+    bool markPooledStrings(); // false - не удалось загрузить образец
+    void resolveOrderings();
+    string convertXsdTypeToCpp(string_view xsdType) const;
+    std::optional<string_view> mappedType(string_view xsdType) const; // Встроенный или простой тип схемы
+    Facets parseFacets(const tinyxml2::XMLElement* restriction) const;
+    Facets facetsOf(string_view xsdType) const;
+    static string_view storageType(string_view type, const Facets& facets);
     static string sanitizeName(string name);
 
     // Методы генерации кода
+    bool generateWriter(const string& outputDir, const string& namespaceName) const;
+    bool generateReader(const string& outputDir, const string& namespaceName) const;
+    bool generateBinary(const string& outputDir, const string& namespaceName) const;
+    bool generateDescriptors(const string& outputDir, const string& namespaceName) const;
+    bool generateLeanHeaders(const string& outputDir, const string& namespaceName) const;
+    bool generateValidator(const string& outputDir, const string& namespaceName) const;
+    bool generateModule(const string& outputDir, const string& namespaceName) const;
+    vector<string> moduleFiles(const string& namespaceName) const;
+    bool generateBench(const string& outputDir, const string& namespaceName) const;
+    bool generateStream(const string& outputDir, const string& namespaceName) const;
+    bool generateHash(const string& outputDir, const string& namespaceName) const;
+    bool generateBatch(const string& outputDir, const string& namespaceName) const;
+    bool generateExpected(const string& outputDir, const string& namespaceName) const;
+    bool generateEmbed(const string& outputDir, const string& namespaceName) const;
+    bool generateMemory(const string& outputDir, const string& namespaceName) const;
+    bool generateTrace(const string& outputDir, const string& namespaceName) const;
+    string hashSpecializations(const string& namespaceName) const; // std::hash структур для Types.h
+    vector<string> lazyItemTypes() const;
+    static string lazyLoadDefinition(bool pooled); // Lazy<T>::load() для Types.h или Reader.h
+    static string_view sharedDefinition();   // Shared<T> для Types.h
+    static string_view internDefinition();   // Interner и loadInterned для Reader.h
+    static string_view pooledStringDefinition(); // StringPool и PooledString для Types.h
+    static string_view pooledLoadDefinition();   // Чтение PooledString и loadPooled для Reader.h
     // string generateEnumHeader(const Enum& enumType) const;
     // string generateEnumSource(const Enum& enumType) const;
     // string generateStructHeader(const ComplexType& complexType) const;
@@ -145,7 +402,7 @@ private:
     // Утилиты для работы со строками
     static string toCamelCase(const string& str);
     static string toUpperCase(string str);
-    static string trim(const string& str);
+    static string trim(string_view str);
 
     ////////////////////////////////////////
     // Дополним приватные методы в классе Parser
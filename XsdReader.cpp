@@ -0,0 +1,752 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+#include <sstream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Разбор значений встроенных типов и загрузка документа (Reader.h)
+constexpr auto valueDeclaration = R"(// Ошибка загрузки: отсутствует обязательный атрибут/элемент или неверное значение
+[[noreturn]] void throwMissing(const tinyxml2::XMLElement* element, const char* what, const char* name);
+
+// Разобранное целое число: модуль и знак
+struct ParsedInteger {
+    std::uint64_t magnitude = 0;
+    bool negative = false;
+    bool bits = false; // Шестнадцатеричная или двоичная запись: задаёт разряды значения
+};
+
+// Целые числа: десятичные, 0x - шестнадцатеричные, # и 0b - двоичные,
+// суффиксы k/m/g/t (scaledNonNegativeInteger). Модуль больше 64 разрядов - исключение
+ParsedInteger parseInteger(const char* text);
+
+// Значение number в типе T; false - не помещается. Минус у беззнакового поля не допускается;
+// разряды знакового поля можно задать только в шестнадцатеричной или двоичной записи (0xFF для int8_t - это -1)
+template <class T>
+    requires std::is_integral_v<T>
+bool narrowInteger(const ParsedInteger& number, T& value) {
+    using Unsigned = std::make_unsigned_t<T>;
+    constexpr auto max = static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+    if(number.negative) {
+        if constexpr(std::is_unsigned_v<T>) {
+            return false;
+        } else {
+            if(number.magnitude > max + 1) return false;
+            value = static_cast<T>(Unsigned{0} - static_cast<Unsigned>(number.magnitude));
+            return true;
+        }
+    }
+    if(number.magnitude <= max || (std::is_signed_v<T> && number.bits && number.magnitude <= std::numeric_limits<Unsigned>::max())) {
+        value = static_cast<T>(static_cast<Unsigned>(number.magnitude));
+        return true;
+    }
+    return false;
+}
+
+void readValue(const char* text, std::string& value);
+void readValue(const char* text, bool& value);
+void readValue(const char* text, std::vector<unsigned char>& value);
+
+// Поля, суженные по фасетам диапазона, не должны молча усекать выходящие за диапазон значения:
+// validate() не проверяет границы, которые обеспечивает сам тип хранения
+template <class T>
+    requires std::is_integral_v<T>
+void readValue(const char* text, T& value) {
+    if(!narrowInteger(parseInteger(text), value))
+        throw std::runtime_error("Integer out of range: " + std::string{text});
+}
+
+template <class T>
+    requires std::is_floating_point_v<T>
+void readValue(const char* text, T& value) {
+    std::string_view view{text ? text : ""};
+    while(!view.empty() && std::isspace(static_cast<unsigned char>(view.front()))) view.remove_prefix(1);
+    if(!view.empty() && view.front() == '+') view.remove_prefix(1);
+    auto [end, ec] = std::from_chars(view.data(), view.data() + view.size(), value);
+    if(ec != std::errc{}) throw std::runtime_error("Invalid number: " + std::string{text ? text : ""});
+}
+
+template <class E>
+    requires std::is_enum_v<E>
+void readValue(const char* text, E& value) {
+    value = stringTo<E>(text ? text : "");
+}
+)"sv;
+
+// Строки фиксированной ёмкости (Options::inlineStrings)
+constexpr auto fixedStringValue = R"(
+template <std::size_t N>
+void readValue(const char* text, FixedString<N>& value) {
+    if(!value.assign(text ? text : ""))
+        throw std::runtime_error("String exceeds " + std::to_string(N) + " bytes: " + std::string{text});
+}
+)"sv;
+
+constexpr auto documentHelpers = R"(// Загружает корневой элемент tag из разобранного документа
+template <class T>
+T readDocument(const tinyxml2::XMLDocument& doc, std::string_view tag) {
+    const tinyxml2::XMLElement* root = doc.RootElement();
+    if(!root || tag != root->Name()) {
+        throw std::runtime_error("Root element <" + std::string{tag} + "> not found");
+    }
+    T value;
+    readXml(root, value);
+    return value;
+}
+
+// Документ вместе с исходным DOM: нужен, пока загрузка не завершена (ленивые коллекции)
+template <class T>
+struct Document {
+    std::unique_ptr<tinyxml2::XMLDocument> dom;
+    T root;
+};
+
+// Загружает документ из файла, сохраняя DOM
+template <class T>
+Document<T> loadDocument(const std::string& path, std::string_view tag) {
+    auto dom = std::make_unique<tinyxml2::XMLDocument>();
+    if(dom->LoadFile(path.c_str()) != tinyxml2::XML_SUCCESS) {
+        throw std::runtime_error("Failed to load " + path + ": " + dom->ErrorStr());
+    }
+    T root = readDocument<T>(*dom, tag);
+    return {std::move(dom), std::move(root)};
+}
+
+// Загружает документ из строки, сохраняя DOM
+template <class T>
+Document<T> parseDocument(std::string_view xml, std::string_view tag) {
+    auto dom = std::make_unique<tinyxml2::XMLDocument>();
+    if(dom->Parse(xml.data(), xml.size()) != tinyxml2::XML_SUCCESS) {
+        throw std::runtime_error(std::string{"Failed to parse XML: "} + dom->ErrorStr());
+    }
+    T root = readDocument<T>(*dom, tag);
+    return {std::move(dom), std::move(root)};
+}
+)"sv;
+
+// Параллельная загрузка больших коллекций (Reader.h, режим Options::parallelCollections)
+constexpr auto poolDeclaration = R"(
+// Пул потоков с перехватом задач для загрузки больших коллекций.
+// Коллекция делится на куски; каждый поток берёт задачи из своей очереди с конца,
+// а опустев - забирает из чужих с начала. Ожидающий поток сам выполняет задачи,
+// поэтому вложенные коллекции тоже распараллеливаются без взаимоблокировок.
+class LoadPool {
+public:
+    explicit LoadPool(unsigned threads = std::thread::hardware_concurrency());
+    LoadPool(const LoadPool&) = delete;
+    LoadPool& operator=(const LoadPool&) = delete;
+    ~LoadPool();
+
+    static LoadPool& instance();
+    unsigned size() const { return static_cast<unsigned>(threads_.size()); }
+
+    // Выполняет body(begin, end) для кусков [0, count) и ждёт завершения.
+    // Из нескольких исключений пробрасывается исключение первого по порядку куска.
+    void parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& body);
+
+private:
+    struct Job;
+    struct Task {
+        Job* job;
+        std::size_t begin;
+        std::size_t end;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool pop(std::size_t self, Task& task);
+    bool steal(std::size_t self, Task& task);
+    void run(const Task& task);
+    void worker(std::size_t index);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<std::size_t> queued_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    bool stop_{false};
+};
+
+// Коллекции короче этого порога загружаются в текущем потоке
+inline std::size_t parallelMinItems = 16;
+
+// Загружает все дочерние элементы tag в items. Каждый элемент пишется в свой слот,
+// поэтому порядок документа и результат не зависят от числа потоков.
+template <class T>
+void readCollection(const tinyxml2::XMLElement* element, const char* tag, std::vector<T>& items) {
+    std::vector<const tinyxml2::XMLElement*> children;
+    for(auto* child = element->FirstChildElement(tag); child; child = child->NextSiblingElement(tag))
+        children.push_back(child);
+    items.resize(children.size());
+)"sv;
+
+constexpr auto collectionBody = R"(    auto body = [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin; i < end; ++i) readXml(children[i], items[i]);
+    };
+)"sv;
+
+// Потоки пула читают строки в пул строк загружающего потока (Options::pooledStrings)
+constexpr auto pooledCollectionBody = R"(    auto body = [&, pool = currentStringPool](std::size_t begin, std::size_t end) {
+        StringPoolScope scope{pool};
+        for(std::size_t i = begin; i < end; ++i) readXml(children[i], items[i]);
+    };
+)"sv;
+
+constexpr auto collectionEnd = R"(    if(children.size() < parallelMinItems) body(0, children.size());
+    else LoadPool::instance().parallelFor(children.size(), body);
+}
+)"sv;
+
+constexpr auto poolDefinition = R"(struct LoadPool::Job {
+    const std::function<void(std::size_t, std::size_t)>* body;
+    std::atomic<std::size_t> pending;
+    std::mutex errorMutex{};
+    std::size_t errorBegin = static_cast<std::size_t>(-1);
+    std::exception_ptr error{};
+};
+
+namespace {
+// Очередь текущего потока: индекс рабочего потока пула, у внешних потоков - нет
+thread_local const LoadPool* currentPool = nullptr;
+thread_local std::size_t currentQueue = 0;
+} // namespace
+
+LoadPool::LoadPool(unsigned threads) {
+    threads = threads ? threads : 1;
+    for(unsigned i = 0; i < threads; ++i) queues_.push_back(std::make_unique<Queue>());
+    for(unsigned i = 0; i < threads; ++i) threads_.emplace_back(&LoadPool::worker, this, i);
+}
+
+LoadPool::~LoadPool() {
+    {
+        std::lock_guard lock{sleepMutex_};
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for(auto& thread: threads_) thread.join();
+}
+
+LoadPool& LoadPool::instance() {
+    static LoadPool pool;
+    return pool;
+}
+
+bool LoadPool::pop(std::size_t self, Task& task) {
+    if(self >= queues_.size()) return false;
+    Queue& queue = *queues_[self];
+    std::lock_guard lock{queue.mutex};
+    if(queue.tasks.empty()) return false;
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    --queued_;
+    return true;
+}
+
+bool LoadPool::steal(std::size_t self, Task& task) {
+    for(std::size_t i = 1; i <= queues_.size(); ++i) {
+        Queue& queue = *queues_[(self + i) % queues_.size()];
+        std::lock_guard lock{queue.mutex};
+        if(queue.tasks.empty()) continue;
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        --queued_;
+        return true;
+    }
+    return false;
+}
+
+void LoadPool::run(const Task& task) {
+    Job& job = *task.job;
+    try {
+        (*job.body)(task.begin, task.end);
+    } catch(...) {
+        std::lock_guard lock{job.errorMutex};
+        if(task.begin < job.errorBegin) {
+            job.errorBegin = task.begin;
+            job.error = std::current_exception();
+        }
+    }
+    job.pending.fetch_sub(1, std::memory_order_release);
+}
+
+void LoadPool::worker(std::size_t index) {
+    currentPool = this;
+    currentQueue = index;
+    for(Task task;;) {
+        if(pop(index, task) || steal(index, task)) {
+            run(task);
+            continue;
+        }
+        std::unique_lock lock{sleepMutex_};
+        wake_.wait(lock, [this] { return stop_ || queued_ > 0; });
+        if(stop_ && queued_ == 0) return;
+    }
+}
+
+void LoadPool::parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& body) {
+    if(count == 0) return;
+    // Несколько кусков на поток сглаживают неравномерную стоимость элементов
+    const std::size_t chunk = std::max<std::size_t>(1, count / (queues_.size() * 4));
+    const std::size_t chunks = (count + chunk - 1) / chunk;
+    if(chunks == 1) return body(0, count);
+
+    Job job{&body, chunks};
+    const std::size_t self = currentPool == this ? currentQueue : queues_.size();
+    // Куски кладутся в обратном порядке: владелец очереди начнёт с первых
+    for(std::size_t i = chunks; i-- > 0;) {
+        Queue& queue = *queues_[self < queues_.size() ? self : i % queues_.size()];
+        std::lock_guard lock{queue.mutex};
+        queue.tasks.push_back({&job, i * chunk, std::min(count, (i + 1) * chunk)});
+        ++queued_;
+    }
+    {
+        std::lock_guard lock{sleepMutex_};
+    }
+    wake_.notify_all();
+
+    // Помогаем пулу, пока не завершены все куски этой коллекции
+    for(Task task; job.pending.load(std::memory_order_acquire) != 0;) {
+        if(pop(self, task) || steal(self < queues_.size() ? self : 0, task)) run(task);
+        else std::this_thread::yield();
+    }
+    if(job.error) std::rethrow_exception(job.error);
+}
+)"sv;
+
+// Обобщённая загрузка по таблице описаний полей (Reader.h, режим Options::descriptors).
+// Ветка повторяющихся вложенных структур зависит от режима коллекций и вставляется между частями.
+constexpr auto readFieldsBegin = R"(
+// Загружает все поля value по meta::Descriptor<T>
+template <class T>
+void readFields(const tinyxml2::XMLElement* element, T& value) {
+    meta::visit(value, [element]<class F>(const F& field, auto& member) {
+        // Куда читать: обязательное поле, std::optional или новый элемент вектора
+        auto target = [&member]() -> decltype(auto) {
+            if constexpr(F::occurs == meta::Occurs::Repeated) return (member.emplace_back());
+            else if constexpr(F::occurs == meta::Occurs::Optional) return (member.emplace());
+            else return (member);
+        };
+        auto read = [&](const tinyxml2::XMLElement* child) {
+            if constexpr(F::kind == meta::Kind::Complex) readXml(child, target());
+            else readValue(child->GetText(), target());
+        };
+
+        if constexpr(F::node == meta::Node::Text) {
+            readValue(element->GetText(), target());
+        } else if constexpr(F::node == meta::Node::Attribute) {
+            if(const char* text = element->Attribute(field.name)) readValue(text, target());
+            else if constexpr(F::occurs == meta::Occurs::Required) throwMissing(element, "attribute", field.name);
+)"sv;
+
+constexpr auto readFieldsLazy = R"(        } else if constexpr(requires { member.isLoaded(); }) {
+            member = {element, field.name};
+)"sv;
+
+constexpr auto readFieldsParallel = R"(        } else if constexpr(F::occurs == meta::Occurs::Repeated && F::kind == meta::Kind::Complex) {
+            readCollection(element, field.name, member);
+)"sv;
+
+constexpr auto readFieldsEnd = R"(        } else if constexpr(F::occurs == meta::Occurs::Repeated) {
+            for(auto* child = element->FirstChildElement(field.name); child; child = child->NextSiblingElement(field.name))
+                read(child);
+        } else {
+            if(auto* child = element->FirstChildElement(field.name)) read(child);
+            else if constexpr(F::occurs == meta::Occurs::Required) throwMissing(element, "element", field.name);
+        }
+    });
+
+    if constexpr(requires { value.rebuildIndexes(); }) value.rebuildIndexes();
+}
+)"sv;
+
+// Декодирование ленивой коллекции (Types.h, в режиме Options::leanHeaders - Reader.h)
+constexpr auto lazyLoad = R"(template <class T>
+void Lazy<T>::load() const {
+)"sv;
+
+constexpr auto lazyLoadPooled = R"(    StringPoolScope scope{pool_};
+)"sv;
+
+constexpr auto lazyLoadBody = R"(    // Неудачная загрузка не оставляет части элементов: следующее обращение читает заново
+    try {
+        for(auto* child = parent_->FirstChildElement(tag_); child; child = child->NextSiblingElement(tag_))
+            readXml(child, items_.emplace_back());
+    } catch(...) {
+        items_.clear();
+        throw;
+    }
+    parent_ = nullptr;
+}
+
+)"sv;
+
+// Записи с ленивыми коллекциями ссылаются на DOM, поэтому выдаются вместе с ним
+constexpr auto lazyRecord = R"(
+// Запись вместе с DOM: ленивые коллекции загружаются из него при обращении
+template <class T>
+using Record = Document<T>;
+
+template <class T>
+Record<T> readRecord(std::string_view xml, std::string_view tag) {
+    return parseDocument<T>(xml, tag);
+}
+
+template <class T>
+Record<T> loadRecord(const std::string& path, std::string_view tag) {
+    return loadDocument<T>(path, tag);
+}
+)"sv;
+
+constexpr auto eagerRecord = R"(
+// Запись - значение структуры, DOM после загрузки не нужен
+template <class T>
+using Record = T;
+
+template <class T>
+Record<T> readRecord(std::string_view xml, std::string_view tag) {
+    return parseXml<T>(xml, tag);
+}
+
+template <class T>
+Record<T> loadRecord(const std::string& path, std::string_view tag) {
+    return loadXml<T>(path, tag);
+}
+)"sv;
+
+// Загрузка без сохранения DOM - только без ленивых коллекций
+constexpr auto eagerHelpers = R"(
+// Загружает документ из файла
+template <class T>
+T loadXml(const std::string& path, std::string_view tag) {
+    tinyxml2::XMLDocument doc;
+    if(doc.LoadFile(path.c_str()) != tinyxml2::XML_SUCCESS) {
+        throw std::runtime_error("Failed to load " + path + ": " + doc.ErrorStr());
+    }
+    return readDocument<T>(doc, tag);
+}
+
+// Загружает документ из строки
+template <class T>
+T parseXml(std::string_view xml, std::string_view tag) {
+    tinyxml2::XMLDocument doc;
+    if(doc.Parse(xml.data(), xml.size()) != tinyxml2::XML_SUCCESS) {
+        throw std::runtime_error(std::string{"Failed to parse XML: "} + doc.ErrorStr());
+    }
+    return readDocument<T>(doc, tag);
+}
+)"sv;
+
+constexpr auto valueDefinition = R"(void throwMissing(const tinyxml2::XMLElement* element, const char* what, const char* name) {
+    throw std::runtime_error(std::string{"Missing required "} + what + " '" + name + "' in <"
+        + element->Name() + "> at line " + std::to_string(element->GetLineNum()));
+}
+
+ParsedInteger parseInteger(const char* text) {
+    std::string_view view{text ? text : ""};
+    while(!view.empty() && std::isspace(static_cast<unsigned char>(view.front()))) view.remove_prefix(1);
+    while(!view.empty() && std::isspace(static_cast<unsigned char>(view.back()))) view.remove_suffix(1);
+
+    bool negative = false;
+    if(!view.empty() && (view.front() == '+' || view.front() == '-')) {
+        negative = view.front() == '-';
+        view.remove_prefix(1);
+    }
+
+    int base = 10;
+    if(view.starts_with("0x") || view.starts_with("0X")) {
+        base = 16, view.remove_prefix(2);
+    } else if(view.starts_with("0b")) {
+        base = 2, view.remove_prefix(2);
+    } else if(view.starts_with("#")) {
+        base = 2, view.remove_prefix(1);
+    }
+
+    std::uint64_t scale = 1;
+    if(!view.empty() && base != 16) {
+        switch(view.back()) {
+        case 'k': case 'K': scale = 1ull << 10; break;
+        case 'm': case 'M': scale = 1ull << 20; break;
+        case 'g': case 'G': scale = 1ull << 30; break;
+        case 't': case 'T': scale = 1ull << 40; break;
+        default: break;
+        }
+        if(scale != 1) view.remove_suffix(1);
+    }
+
+    std::uint64_t value = 0;
+    auto [end, ec] = std::from_chars(view.data(), view.data() + view.size(), value, base);
+    if(ec == std::errc::result_out_of_range || value > std::numeric_limits<std::uint64_t>::max() / scale) {
+        throw std::runtime_error("Integer out of range: " + std::string{text});
+    }
+    if(view.empty() || ec != std::errc{} || end != view.data() + view.size()) {
+        throw std::runtime_error("Invalid integer: " + std::string{text ? text : ""});
+    }
+    return {value * scale, negative, base != 10};
+}
+
+void readValue(const char* text, std::string& value) {
+    value = text ? text : "";
+}
+
+void readValue(const char* text, bool& value) {
+    std::string_view view{text ? text : ""};
+    if(view == "true" || view == "1") value = true;
+    else if(view == "false" || view == "0") value = false;
+    else throw std::runtime_error("Invalid boolean: " + std::string{view});
+}
+
+void readValue(const char* text, std::vector<unsigned char>& value) {
+    std::string_view view{text ? text : ""};
+    if(view.size() % 2) throw std::runtime_error("Invalid hexBinary: " + std::string{view});
+    value.clear();
+    value.reserve(view.size() / 2);
+    for(std::size_t i = 0; i < view.size(); i += 2) {
+        unsigned char byte = 0;
+        auto [end, ec] = std::from_chars(view.data() + i, view.data() + i + 2, byte, 16);
+        if(ec != std::errc{} || end != view.data() + i + 2) throw std::runtime_error("Invalid hexBinary: " + std::string{view});
+        value.push_back(byte);
+    }
+}
+)"sv;
+
+} // namespace
+
+string Parser::lazyLoadDefinition(bool pooled) {
+    return string{lazyLoad} + string{pooled ? lazyLoadPooled : ""} + string{lazyLoadBody};
+}
+
+string ComplexType::generateReaderDecl() const {
+    return std::format("void readXml(const tinyxml2::XMLElement* element, {}& value);\n", name);
+}
+
+string ComplexType::generateReaderCode(const Options& options) const {
+    std::stringstream ss;
+
+    // У структуры без полей параметры не используются
+    const string_view unused = fields.empty() && !options.descriptors ? "[[maybe_unused]] "sv : ""sv;
+    println(ss, "void readXml({0}const tinyxml2::XMLElement* element, {0}{1}& value) {{", unused, name);
+    // Событие трассировки на время чтения элемента (Trace.h)
+    if(options.trace) {
+        println(ss, "    XSD_GENERATED_TRACE_SCOPE(\"{}\", element);", name);
+    }
+    // Учёт памяти: объект типа и байты в куче каждого прочитанного поля (Memory.h)
+    if(options.memoryReport) {
+        println(ss, "    XSD_GENERATED_MEMORY_SITE(\"{0}\", sizeof({0}));", name);
+    }
+    auto accountField = [&](const Field& field) {
+        if(options.memoryReport)
+            println(ss, "    XSD_GENERATED_MEMORY_SITE(\"{0}.{1}\", memory::heapBytes(value.{1}));", name, field.name);
+    };
+
+    // Тело строится шаблоном readFields по таблице описаний
+    if(options.descriptors) {
+        println(ss, "    readFields(element, value);");
+        println(ss, "}}\n");
+        return ss.str();
+    }
+
+    for(const auto& field: fields) {
+        // Куда читать: обязательное поле, std::optional или новый элемент вектора
+        const string target = field.isRepeated()
+            ? std::format("value.{}.emplace_back()", field.name)
+            : field.isOptional
+            ? std::format("value.{}.emplace()", field.name)
+            : std::format("value.{}", field.name);
+
+        if(field.isText) {
+            println(ss, "    readValue(element->GetText(), {});", target);
+            accountField(field);
+            continue;
+        }
+
+        if(field.isAttribute) {
+            println(ss, "    if(const char* text = element->Attribute(\"{}\")) readValue(text, {});", field.xmlName, target);
+            if(!field.isOptional)
+                println(ss, "    else throwMissing(element, \"attribute\", \"{}\");", field.xmlName);
+            accountField(field);
+            continue;
+        }
+
+        // Ленивая коллекция запоминает только родительский элемент и имя
+        if(options.isLazy(field)) {
+            println(ss, "    value.{} = {{element, \"{}\"}};", field.name, field.xmlName);
+            continue;
+        }
+
+        // Большая коллекция делится на куски между потоками LoadPool
+        if(options.isParallel(field)) {
+            println(ss, "    readCollection(element, \"{}\", value.{});", field.xmlName, field.name);
+            accountField(field);
+            continue;
+        }
+
+        const string read = field.kind == Field::Kind::Complex
+            ? std::format("readXml(child, {});", target)
+            : std::format("readValue(child->GetText(), {});", target);
+
+        if(field.isRepeated()) {
+            println(ss, "    for(auto* child = element->FirstChildElement(\"{0}\"); child; child = child->NextSiblingElement(\"{0}\"))", field.xmlName);
+            println(ss, "        {}", read);
+        } else {
+            println(ss, "    if(auto* child = element->FirstChildElement(\"{}\")) {}", field.xmlName, read);
+            if(!field.isOptional)
+                println(ss, "    else throwMissing(element, \"element\", \"{}\");", field.xmlName);
+        }
+        accountField(field);
+    }
+
+    // Индексы xs:key/xs:unique строятся сразу после загрузки коллекций
+    if(!constraints.empty()) {
+        println(ss, "    value.rebuildIndexes();");
+    }
+
+    println(ss, "}}\n");
+
+    return ss.str();
+}
+
+bool Parser::generateReader(const string& outputDir, const string& namespaceName) const {
+    std::ofstream header(outputDir + "/Reader.h");
+    if(!header.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Reader.h", outputDir);
+        return false;
+    }
+
+    println(header, "#pragma once\n");
+    println(header, "#include <cctype>");
+    println(header, "#include <charconv>");
+    println(header, "#include <cstdint>");
+    println(header, "#include <limits>");
+    println(header, "#include <memory>");
+    println(header, "#include <stdexcept>");
+    println(header, "#include <string>");
+    println(header, "#include <string_view>");
+    println(header, "#include <type_traits>");
+    println(header, "#include <vector>");
+    if(options_.intern) {
+        println(header, "#include <mutex>");
+        println(header, "#include <typeindex>");
+        println(header, "#include <typeinfo>");
+        println(header, "#include <unordered_map>");
+    }
+    if(options_.parallelCollections) {
+        println(header, "#include <algorithm>");
+        println(header, "#include <atomic>");
+        println(header, "#include <condition_variable>");
+        println(header, "#include <deque>");
+        println(header, "#include <functional>");
+        println(header, "#include <mutex>");
+        println(header, "#include <thread>");
+    }
+    println(header, "#include \"tinyxml2.h\"");
+    if(options_.leanHeaders) {
+        println(header, "#include \"Enums_io.h\"");
+    }
+    println(header, "#include \"{}\"\n", options_.descriptors ? "Descriptors.h" : "Types.h");
+
+    if(!namespaceName.empty()) {
+        println(header, "namespace {} {{\n", namespaceName);
+    }
+
+    header << valueDeclaration;
+    if(options_.inlineStrings > 0) {
+        header << fixedStringValue;
+    }
+    header << '\n';
+
+    for(const auto& complexType: complexTypes) {
+        header << complexType.generateReaderDecl();
+    }
+
+    // Определение Lazy<T>::load() вынесено из лёгкого Types.h
+    if(options_.leanHeaders && options_.lazyCollections) {
+        header << '\n'
+               << lazyLoadDefinition(options_.isPooling());
+    }
+
+    if(options_.parallelCollections) {
+        header << poolDeclaration
+               << (options_.isPooling() ? pooledCollectionBody : collectionBody)
+               << collectionEnd;
+    }
+
+    if(options_.descriptors) {
+        header << readFieldsBegin;
+        if(options_.lazyCollections) header << readFieldsLazy;
+        if(options_.parallelCollections) header << readFieldsParallel;
+        header << readFieldsEnd;
+    }
+
+    header << '\n'
+           << documentHelpers;
+    if(!options_.lazyCollections) {
+        header << eagerHelpers;
+    }
+    // Отдельные записи и файлы пакета (Stream.h, Batch.h), загрузка с разделением поддеревьев и пулом строк
+    if(options_.streaming || options_.batch || options_.intern || options_.isPooling()) {
+        header << (options_.lazyCollections ? lazyRecord : eagerRecord);
+    }
+    if(options_.intern) {
+        header << internDefinition();
+    }
+    if(options_.isPooling()) {
+        header << pooledLoadDefinition();
+    }
+
+    if(!namespaceName.empty()) {
+        println(header, "\n}} // namespace {}", namespaceName);
+    }
+
+    header.close();
+
+    std::ofstream source(outputDir + "/Reader.cpp");
+    if(!source.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Reader.cpp", outputDir);
+        return false;
+    }
+
+    println(source, "#include \"Reader.h\"");
+    if(options_.memoryReport) {
+        println(source, "#include \"Memory.h\"");
+    }
+    if(options_.trace) {
+        println(source, "#include \"Trace.h\"");
+    }
+    println(source);
+
+    if(!namespaceName.empty()) {
+        println(source, "namespace {} {{\n", namespaceName);
+    }
+
+    source << valueDefinition << '\n';
+    if(options_.parallelCollections) {
+        source << poolDefinition << '\n';
+    }
+
+    for(const auto& complexType: complexTypes) {
+        source << complexType.generateReaderCode(options_);
+    }
+
+    // Единственное место инстанцирования ленивых коллекций (extern template в Types.h)
+    if(options_.leanHeaders && options_.lazyCollections) {
+        for(const auto& type: lazyItemTypes()) {
+            println(source, "template class Lazy<{}>;", type);
+        }
+        println(source);
+    }
+
+    if(!namespaceName.empty()) {
+        println(source, "}} // namespace {}", namespaceName);
+    }
+
+    source.close();
+    return true;
+}
+
+} // namespace Xsd
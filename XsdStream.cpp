@@ -0,0 +1,226 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+#include <set>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Поиск записей в потоке и чтение их по мере поступления (Stream.h)
+constexpr auto scannerDeclaration = R"(// Размер порции чтения входного потока по умолчанию
+inline constexpr std::size_t defaultChunkSize = 64 * 1024;
+
+// Выделяет из текста, поступающего порциями, полные элементы tag (записи).
+// В буфере хранится только незавершённая запись и необработанный хвост порции,
+// поэтому память ограничена размером одной записи, а не документа.
+// Вложенные элементы с тем же именем входят в запись внешнего.
+class RecordScanner {
+public:
+    explicit RecordScanner(std::string_view tag);
+
+    // Добавляет порцию текста; ранее выданные записи становятся недействительными
+    void feed(std::string_view chunk);
+    // Следующая полная запись "<tag ...>...</tag>"; nullopt - нужна следующая порция
+    std::optional<std::string_view> next();
+    // Конец входа: исключение, если запись оборвана
+    void finish() const;
+
+private:
+    std::size_t markupEnd(std::size_t open) const;
+
+    std::string tag_;
+    std::string buffer_;
+    std::size_t pos_ = 0;   // Начало непросмотренного текста
+    std::size_t start_ = 0; // Начало текущей записи
+    std::size_t depth_ = 0; // Открытые элементы текущей записи; 0 - вне записи
+};
+)"sv;
+
+constexpr auto recordReaders = R"(
+// Читает порции input и передаёт consume каждую запись tag сразу после её закрывающего тега
+template <class T, class F>
+void forEachRecord(std::istream& input, std::string_view tag, F&& consume, std::size_t chunkSize = defaultChunkSize) {
+    RecordScanner scanner{tag};
+    std::string chunk(chunkSize, '\0');
+    while(input) {
+        input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        scanner.feed({chunk.data(), static_cast<std::size_t>(input.gcount())});
+        while(auto record = scanner.next()) consume(readRecord<T>(*record, tag));
+    }
+    scanner.finish();
+}
+
+// Без std::generator (например, libstdc++ до 14) readRecords не объявляется: используйте forEachRecord
+#if defined(__cpp_lib_generator)
+// Записи tag из input по мере поступления; tag копируется, так как сопрограмма переживает вызов
+template <class T>
+std::generator<Record<T>> readRecords(std::istream& input, std::string tag, std::size_t chunkSize = defaultChunkSize) {
+    RecordScanner scanner{tag};
+    std::string chunk(chunkSize, '\0');
+    while(input) {
+        input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        scanner.feed({chunk.data(), static_cast<std::size_t>(input.gcount())});
+        while(auto record = scanner.next()) co_yield readRecord<T>(*record, tag);
+    }
+    scanner.finish();
+}
+#endif
+)"sv;
+
+constexpr auto scannerDefinition = R"(RecordScanner::RecordScanner(std::string_view tag)
+    : tag_{tag} {
+}
+
+void RecordScanner::feed(std::string_view chunk) {
+    // Просмотренный текст вне записи и выданные записи больше не нужны
+    const std::size_t keep = depth_ ? start_ : pos_;
+    buffer_.erase(0, keep);
+    pos_ -= keep;
+    start_ = depth_ ? start_ - keep : 0;
+    buffer_.append(chunk);
+}
+
+// Конец разметки, начинающейся в open (за '>'); npos - разметка ещё не поступила целиком
+std::size_t RecordScanner::markupEnd(std::size_t open) const {
+    constexpr auto npos = std::string::npos;
+    auto after = [&](std::string_view terminator, std::size_t from) {
+        const std::size_t end = buffer_.find(terminator, from);
+        return end == npos ? npos : end + terminator.size();
+    };
+    const std::string_view rest = std::string_view{buffer_}.substr(open);
+    if(rest.size() < 2) return npos;
+    if(rest[1] == '?') return after("?>", open + 2);
+    if(rest[1] == '!') {
+        // Различить комментарий, CDATA и объявление можно только по первым 9 символам
+        if(rest.size() < 9) return npos;
+        if(rest.starts_with("<!--")) return after("-->", open + 4);
+        if(rest.starts_with("<![CDATA[")) return after("]]>", open + 9);
+    }
+    // Тег или <!DOCTYPE>: '>' в кавычках и во внутреннем подмножестве DTD не завершает разметку
+    char quote = 0;
+    int brackets = 0;
+    for(std::size_t i = 1; i < rest.size(); ++i) {
+        const char c = rest[i];
+        if(quote) {
+            if(c == quote) quote = 0;
+        } else if(c == '"' || c == '\'') {
+            quote = c;
+        } else if(c == '[') {
+            ++brackets;
+        } else if(c == ']') {
+            --brackets;
+        } else if(c == '>' && brackets <= 0) {
+            return open + i + 1;
+        }
+    }
+    return npos;
+}
+
+std::optional<std::string_view> RecordScanner::next() {
+    while(true) {
+        const std::size_t open = buffer_.find('<', pos_);
+        if(open == std::string::npos) {
+            pos_ = buffer_.size();
+            return std::nullopt;
+        }
+        pos_ = open;
+        const std::size_t end = markupEnd(open);
+        if(end == std::string::npos) return std::nullopt;
+        pos_ = end;
+
+        const std::string_view markup{buffer_.data() + open, end - open};
+        if(markup[1] == '?' || markup[1] == '!') continue;
+        if(markup[1] == '/') {
+            if(depth_ && --depth_ == 0) return std::string_view{buffer_.data() + start_, end - start_};
+            continue;
+        }
+        const bool empty = markup[markup.size() - 2] == '/';
+        if(depth_) {
+            depth_ += empty ? 0 : 1;
+            continue;
+        }
+        const std::size_t nameEnd = markup.find_first_of(" \t\r\n/>", 1);
+        if(markup.substr(1, nameEnd - 1) != tag_) continue;
+        start_ = open;
+        if(empty) return markup;
+        depth_ = 1;
+    }
+}
+
+void RecordScanner::finish() const {
+    if(depth_) throw std::runtime_error("Truncated record <" + tag_ + ">");
+}
+)"sv;
+
+} // namespace
+
+// Потоковая загрузка повторяющихся элементов (Options::streaming): записи читаются
+// по мере поступления входа, не дожидаясь конца документа
+bool Parser::generateStream(const string& outputDir, const string& namespaceName) const {
+    std::ofstream header(outputDir + "/Stream.h");
+    if(!header.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Stream.h", outputDir);
+        return false;
+    }
+
+    println(header, "#pragma once\n");
+    println(header, "#include <cstddef>");
+    println(header, "#include <istream>");
+    println(header, "#include <optional>");
+    println(header, "#include <string>");
+    println(header, "#include <string_view>");
+    println(header, "#if __has_include(<generator>)");
+    println(header, "#include <generator>");
+    println(header, "#endif");
+    println(header, "#include \"Reader.h\"\n");
+
+    // Кандидаты в записи - повторяющиеся элементы со структурой
+    std::set<std::pair<string, string>> records;
+    for(const auto& complexType: complexTypes) {
+        for(const auto& field: complexType.fields) {
+            if(field.isRepeated() && field.kind == Field::Kind::Complex && !field.isAttribute) {
+                records.emplace(field.xmlName.empty() ? field.name : field.xmlName, field.type);
+            }
+        }
+    }
+    if(!records.empty()) {
+        println(header, "// Повторяющиеся элементы схемы. readRecords есть только при поддержке std::generator");
+        println(header, "// (__cpp_lib_generator); без неё те же записи выдаёт forEachRecord с обработчиком:");
+        for(const auto& [tag, type]: records) {
+            println(header, "//   readRecords<{0}>(input, \"{1}\") или forEachRecord<{0}>(input, \"{1}\", consume)", type, tag);
+        }
+        println(header);
+    }
+
+    if(!namespaceName.empty()) {
+        println(header, "namespace {} {{\n", namespaceName);
+    }
+    header << scannerDeclaration
+           << recordReaders;
+    if(!namespaceName.empty()) {
+        println(header, "\n}} // namespace {}", namespaceName);
+    }
+    header.close();
+
+    std::ofstream source(outputDir + "/Stream.cpp");
+    if(!source.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Stream.cpp", outputDir);
+        return false;
+    }
+
+    println(source, "#include \"Stream.h\"");
+    println(source, "#include <stdexcept>\n");
+    if(!namespaceName.empty()) {
+        println(source, "namespace {} {{\n", namespaceName);
+    }
+    source << scannerDefinition;
+    if(!namespaceName.empty()) {
+        println(source, "\n}} // namespace {}", namespaceName);
+    }
+    return true;
+}
+
+} // namespace Xsd
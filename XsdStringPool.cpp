@@ -0,0 +1,228 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+#include <set>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+constexpr int sampleMinOccurrences = 32; // Реже встречающиеся в образце поля не выбираются
+constexpr int sampleMinReuse = 2;        // Значение поля повторяется в среднем хотя бы столько раз
+
+// Строки из пула (Types.h, Options::pooledStrings)
+constexpr auto pooledStringDeclaration = R"(class PooledString;
+
+// Пул строк документа: каждый различный текст хранится один раз, PooledString ссылается на него.
+// Пул должен жить дольше загруженной из него модели; добавлять строки можно из нескольких потоков.
+class StringPool {
+public:
+    StringPool() = default;
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    PooledString intern(std::string_view text);
+
+    // Добавлено непустых строк всего и различных среди них
+    std::size_t requests() const {
+        std::lock_guard lock{mutex_};
+        return requests_;
+    }
+    std::size_t size() const {
+        std::lock_guard lock{mutex_};
+        return texts_.size();
+    }
+
+    // Пул строк, созданных вне StringPoolScope; не уничтожается до конца программы
+    static StringPool& global() {
+        static StringPool* pool = new StringPool;
+        return *pool;
+    }
+
+private:
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_set<std::string, Hash, std::equal_to<>> texts_;
+    std::size_t requests_ = 0;
+};
+
+// Пул строк, загружаемых текущим потоком; nullptr - StringPool::global().
+// Ленивые коллекции запоминают пул потока, загрузившего документ
+inline thread_local StringPool* currentStringPool = nullptr;
+
+// Назначает пул строк текущего потока на время своей жизни
+class StringPoolScope {
+public:
+    explicit StringPoolScope(StringPool* pool)
+        : previous_{currentStringPool} {
+        currentStringPool = pool;
+    }
+    ~StringPoolScope() { currentStringPool = previous_; }
+    StringPoolScope(const StringPoolScope&) = delete;
+    StringPoolScope& operator=(const StringPoolScope&) = delete;
+
+private:
+    StringPool* previous_;
+};
+
+// Неизменяемая строка из пула - один указатель. Строки одного пула равны тогда и только тогда,
+// когда равны указатели; сравнение и хеш строк разных пулов - по содержимому, как у std::string.
+// Пустая строка общая для всех пулов
+class PooledString {
+public:
+    PooledString() = default;
+    // text помещается в пул текущего потока
+    explicit PooledString(std::string_view text)
+        : PooledString{(currentStringPool ? *currentStringPool : StringPool::global()).intern(text)} { }
+
+    const std::string& str() const { return *text_; }
+    std::string_view view() const { return *text_; }
+    std::size_t size() const { return text_->size(); }
+    bool empty() const { return text_->empty(); }
+    const char* data() const { return text_->data(); }
+    const char* c_str() const { return text_->c_str(); }
+    const char* begin() const { return text_->data(); }
+    const char* end() const { return text_->data() + text_->size(); }
+    operator std::string_view() const { return *text_; }
+
+    // Совпадение указателей - быстрый путь; строки разных пулов сравниваются по содержимому
+    friend bool operator==(const PooledString& left, const PooledString& right) {
+        return left.text_ == right.text_ || left.view() == right.view();
+    }
+    friend bool operator==(const PooledString& left, std::string_view right) { return left.view() == right; }
+    // Порядок по содержимому, как у std::string
+    friend std::strong_ordering operator<=>(const PooledString& left, const PooledString& right) {
+        return left.text_ == right.text_ ? std::strong_ordering::equal : left.view() <=> right.view();
+    }
+
+private:
+    friend class StringPool;
+    explicit PooledString(const std::string* text)
+        : text_{text} { }
+
+    static const std::string* emptyText() {
+        static const std::string text;
+        return &text;
+    }
+
+    const std::string* text_ = emptyText();
+};
+
+inline PooledString StringPool::intern(std::string_view text) {
+    if(text.empty()) return {};
+    std::lock_guard lock{mutex_};
+    ++requests_;
+    auto it = texts_.find(text);
+    if(it == texts_.end()) it = texts_.emplace(text).first;
+    return PooledString{&*it};
+}
+
+)"sv;
+
+// Чтение строк в пул и загрузка документа со своим пулом (Reader.h)
+constexpr auto pooledLoadDeclaration = R"(
+inline void readValue(const char* text, PooledString& value) {
+    value = PooledString{text ? text : ""};
+}
+
+// Загружает документ, помещая строки PooledString в pool
+template <class T>
+Record<T> loadPooled(const std::string& path, std::string_view tag, StringPool& pool) {
+    StringPoolScope scope{&pool};
+    return loadRecord<T>(path, tag);
+}
+
+template <class T>
+Record<T> parsePooled(std::string_view xml, std::string_view tag, StringPool& pool) {
+    StringPoolScope scope{&pool};
+    return readRecord<T>(xml, tag);
+}
+)"sv;
+
+// Число значений и различных значений листовых элементов и атрибутов образца по имени;
+// имена атрибутов начинаются с '@'
+struct ValueCounts {
+    int occurrences{0};
+    std::set<string> values;
+};
+
+void countValues(const tinyxml2::XMLElement* element, std::map<string, ValueCounts>& counts) {
+    for(auto* attribute = element->FirstAttribute(); attribute; attribute = attribute->Next()) {
+        auto& count = counts["@"s + attribute->Name()];
+        ++count.occurrences;
+        count.values.emplace(attribute->Value());
+    }
+    if(!element->FirstChildElement()) {
+        auto& count = counts[element->Name()];
+        ++count.occurrences;
+        count.values.emplace(element->GetText() ? element->GetText() : "");
+    }
+    for(auto* child = element->FirstChildElement(); child; child = child->NextSiblingElement()) {
+        countValues(child, counts);
+    }
+}
+
+} // namespace
+
+// Строковые поля с повторяющимися значениями хранятся как PooledString (Options::pooledStrings):
+// поля, названные явно (имя XML или Тип.поле), и поля, значения которых в образце XML
+// повторяются в среднем не меньше sampleMinReuse раз. Строки с фиксированной ёмкостью не меняются
+bool Parser::markPooledStrings() {
+    std::map<string, ValueCounts> counts;
+    if(!options_.pooledStringsSample.empty()) {
+        tinyxml2::XMLDocument sample;
+        if(sample.LoadFile(options_.pooledStringsSample.c_str()) != tinyxml2::XML_SUCCESS) {
+            println(std::cerr, "Ошибка загрузки образца: {}", options_.pooledStringsSample);
+            println(std::cerr, "Код ошибки: {}", sample.ErrorStr());
+            return false;
+        }
+        if(const auto* root = sample.RootElement()) countValues(root, counts);
+    }
+
+    auto named = [this](const ComplexType& owner, const Field& field) {
+        return std::ranges::any_of(options_.pooledStrings, [&](const string& name) {
+            return name == field.xmlName || name == owner.name + "." + field.name;
+        });
+    };
+    auto key = [](const Field& field) { return field.isAttribute ? "@" + field.xmlName : field.xmlName; };
+    auto repeats = [&](const Field& field) {
+        if(field.isText) return false; // Текст элемента со структурой в образце не отличить от других
+        auto it = counts.find(key(field));
+        if(it == counts.end()) return false;
+        const auto& [occurrences, values] = it->second;
+        return occurrences >= sampleMinOccurrences && values.size() * sampleMinReuse <= static_cast<size_t>(occurrences);
+    };
+
+    std::set<string> pooled;
+    for(auto& complexType: complexTypes) {
+        for(auto& field: complexType.fields) {
+            if(field.type != "std::string" || !(named(complexType, field) || repeats(field))) continue;
+            field.type = "PooledString";
+            pooled.insert(key(field));
+        }
+    }
+
+    if(pooled.empty()) {
+        println(std::cout, "  Предупреждение: нет строковых полей для пула строк");
+        return true;
+    }
+    println(std::cout, "Поля в пуле строк:");
+    for(const auto& name: pooled) {
+        if(auto it = counts.find(name); it != counts.end())
+            println(std::cout, "  {}: {} значений, {} различных", name, it->second.occurrences, it->second.values.size());
+        else
+            println(std::cout, "  {}", name);
+    }
+    return true;
+}
+
+string_view Parser::pooledStringDefinition() { return pooledStringDeclaration; }
+string_view Parser::pooledLoadDefinition() { return pooledLoadDeclaration; }
+
+} // namespace Xsd
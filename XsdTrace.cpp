@@ -0,0 +1,224 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Событие загрузки и его запись из readXml (Trace.h)
+constexpr auto traceDeclaration = R"(namespace trace {
+
+// Время от первого обращения к трассировке, нс
+std::uint64_t now();
+
+// Завершённое чтение элемента: тип, начало и длительность, строка и смещение
+// начального тега от корневого элемента документа
+void record(const char* type, std::uint64_t begin, std::uint64_t end, std::ptrdiff_t offset, int line);
+
+// Чтение одного элемента: событие пишется в кольцевой буфер при выходе из readXml,
+// в том числе по исключению
+class Scope {
+public:
+    Scope(const char* type, const tinyxml2::XMLElement* element)
+        : type_{type}
+        , begin_{now()}
+        , offset_{element->Value() - element->GetDocument()->RootElement()->Value()}
+        , line_{element->GetLineNum()} { }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope() { record(type_, begin_, now(), offset_, line_); }
+
+private:
+    const char* type_;
+    std::uint64_t begin_;
+    std::ptrdiff_t offset_;
+    int line_;
+};
+
+} // namespace trace
+
+// Последние XSD_GENERATED_TRACE_CAPACITY событий с запуска или resetTrace()
+// в формате Chrome trace (chrome://tracing, ui.perfetto.dev)
+std::string traceJson();
+bool saveTrace(const std::string& path);
+void resetTrace();
+)"sv;
+
+// Кольцевой буфер без блокировок: место выдаёт счётчик, целостность записи
+// проверяется номером версии места, как в seqlock
+constexpr auto traceDefinition = R"(namespace trace {
+
+namespace {
+
+static_assert((XSD_GENERATED_TRACE_CAPACITY & (XSD_GENERATED_TRACE_CAPACITY - 1)) == 0,
+    "XSD_GENERATED_TRACE_CAPACITY must be a power of two");
+
+// Версия 2 * (номер + 1) - запись номер завершена, нечётная - идёт запись
+struct Slot {
+    std::atomic<std::uint64_t> version{0};
+    std::atomic<const char*> type{nullptr};
+    std::atomic<std::uint64_t> begin{0};
+    std::atomic<std::uint64_t> duration{0};
+    std::atomic<std::ptrdiff_t> offset{0};
+    std::atomic<int> line{0};
+    std::atomic<unsigned> thread{0};
+};
+
+struct Event {
+    const char* type;
+    std::uint64_t begin;
+    std::uint64_t duration;
+    std::ptrdiff_t offset;
+    int line;
+    unsigned thread;
+};
+
+// Буфер создаётся первой записью: без трассировки память не занимается
+Slot& slot(std::uint64_t number) {
+    static const std::unique_ptr<Slot[]> slots{new Slot[XSD_GENERATED_TRACE_CAPACITY]};
+    return slots[number & (XSD_GENERATED_TRACE_CAPACITY - 1)];
+}
+
+std::atomic<std::uint64_t> next{0};
+std::atomic<std::uint64_t> first{0}; // Первый номер после resetTrace()
+std::atomic<unsigned> threads{0};
+const auto epoch = std::chrono::steady_clock::now();
+
+unsigned threadId() {
+    thread_local const unsigned id = threads.fetch_add(1, std::memory_order_relaxed) + 1;
+    return id;
+}
+
+// Копия завершённой записи number, если она ещё не перезаписана
+bool read(std::uint64_t number, Event& event) {
+    const Slot& slot = trace::slot(number);
+    const std::uint64_t version = slot.version.load(std::memory_order_acquire);
+    if(version != 2 * (number + 1)) return false;
+    event = {slot.type.load(std::memory_order_relaxed), slot.begin.load(std::memory_order_relaxed),
+        slot.duration.load(std::memory_order_relaxed), slot.offset.load(std::memory_order_relaxed),
+        slot.line.load(std::memory_order_relaxed), slot.thread.load(std::memory_order_relaxed)};
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.version.load(std::memory_order_relaxed) == version;
+}
+
+} // namespace
+
+std::uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void record(const char* type, std::uint64_t begin, std::uint64_t end, std::ptrdiff_t offset, int line) {
+    const std::uint64_t number = next.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = trace::slot(number);
+    slot.version.store(2 * number + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.type.store(type, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.duration.store(end - begin, std::memory_order_relaxed);
+    slot.offset.store(offset, std::memory_order_relaxed);
+    slot.line.store(line, std::memory_order_relaxed);
+    slot.thread.store(threadId(), std::memory_order_relaxed);
+    slot.version.store(2 * (number + 1), std::memory_order_release);
+}
+
+} // namespace trace
+
+std::string traceJson() {
+    std::string out = "{\"traceEvents\":[";
+    if(XSD_GENERATED_TRACE) {
+        const std::uint64_t last = trace::next.load(std::memory_order_acquire);
+        std::uint64_t number = trace::first.load(std::memory_order_relaxed);
+        if(last - number > XSD_GENERATED_TRACE_CAPACITY) number = last - XSD_GENERATED_TRACE_CAPACITY;
+        bool comma = false;
+        for(trace::Event event; number < last; ++number) {
+            if(!trace::read(number, event)) continue;
+            char line[256];
+            std::snprintf(line, sizeof line,
+                "%s\n{\"name\":\"%s\",\"cat\":\"load\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,"
+                "\"args\":{\"line\":%d,\"offset\":%td}}",
+                comma ? "," : "", event.type, event.begin / 1000.0, event.duration / 1000.0, event.thread, event.line, event.offset);
+            out += line;
+            comma = true;
+        }
+    }
+    out += "\n],\"displayTimeUnit\":\"ns\"}\n";
+    return out;
+}
+
+bool saveTrace(const std::string& path) {
+    std::ofstream file(path, std::ios::binary);
+    file << traceJson();
+    return static_cast<bool>(file);
+}
+
+void resetTrace() {
+    trace::first.store(trace::next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+)"sv;
+
+} // namespace
+
+// Трассировка загрузки (Options::trace): Trace.h с событием чтения элемента и макросом
+// XSD_GENERATED_TRACE_SCOPE в начале каждого readXml. Без XSD_GENERATED_TRACE=1 макрос пуст
+bool Parser::generateTrace(const string& outputDir, const string& namespaceName) const {
+    std::ofstream header(outputDir + "/Trace.h");
+    if(!header.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Trace.h", outputDir);
+        return false;
+    }
+
+    const string scope = namespaceName.empty() ? "::" : "::" + namespaceName + "::";
+    println(header, "#pragma once\n");
+    println(header, "#include <cstddef>");
+    println(header, "#include <cstdint>");
+    println(header, "#include <string>");
+    println(header, "#include \"tinyxml2.h\"\n");
+    println(header, "// Трассировка загрузки включается при компиляции: -DXSD_GENERATED_TRACE=1");
+    println(header, "// (CMake: -DXSD_GENERATED_TRACE=ON). Размер кольцевого буфера - степень двойки");
+    println(header, "#ifndef XSD_GENERATED_TRACE");
+    println(header, "#define XSD_GENERATED_TRACE 0");
+    println(header, "#endif");
+    println(header, "#ifndef XSD_GENERATED_TRACE_CAPACITY");
+    println(header, "#define XSD_GENERATED_TRACE_CAPACITY 65536");
+    println(header, "#endif\n");
+    println(header, "// Событие чтения элемента element типом type до конца текущего блока");
+    println(header, "#if XSD_GENERATED_TRACE");
+    println(header, "#define XSD_GENERATED_TRACE_SCOPE(type, element) {}trace::Scope traceScope{{type, element}}", scope);
+    println(header, "#else");
+    println(header, "#define XSD_GENERATED_TRACE_SCOPE(type, element) ((void)0)");
+    println(header, "#endif\n");
+    if(!namespaceName.empty()) {
+        println(header, "namespace {} {{\n", namespaceName);
+    }
+    header << traceDeclaration;
+    if(!namespaceName.empty()) {
+        println(header, "\n}} // namespace {}", namespaceName);
+    }
+    header.close();
+
+    std::ofstream source(outputDir + "/Trace.cpp");
+    if(!source.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Trace.cpp", outputDir);
+        return false;
+    }
+
+    println(source, "#include \"Trace.h\"");
+    println(source, "#include <atomic>");
+    println(source, "#include <chrono>");
+    println(source, "#include <cstdio>");
+    println(source, "#include <fstream>");
+    println(source, "#include <memory>\n");
+    if(!namespaceName.empty()) {
+        println(source, "namespace {} {{\n", namespaceName);
+    }
+    source << traceDefinition;
+    if(!namespaceName.empty()) {
+        println(source, "\n}} // namespace {}", namespaceName);
+    }
+    return true;
+}
+
+} // namespace Xsd
@@ -0,0 +1,1026 @@
+#include "XsdParser.h"
+#include <charconv>
+#include <climits>
+#include <format>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+////////////////////////////////////////
+// Компиляция xs:pattern в детерминированный автомат во время генерации.
+// Автомат работает над кодовыми точками Unicode; шаблон XSD неявно привязан к началу и концу строки.
+
+constexpr char32_t maxCodePoint = 0x10FFFF;
+constexpr size_t maxDfaStates = 4096; // Больше - шаблон не проверяется (предупреждение)
+static_assert(maxDfaStates <= 65536, "состояния адресуются Transition::target типа std::uint16_t");
+constexpr int maxRepeat = 1000;       // Предел {n,m} при развёртке повторений
+
+// Множество кодовых точек: отсортированные непересекающиеся диапазоны
+using CharSet = vector<std::pair<char32_t, char32_t>>;
+
+CharSet normalized(CharSet set) {
+    std::ranges::sort(set);
+    CharSet result;
+    for(const auto& [first, last]: set) {
+        if(!result.empty() && first <= result.back().second + 1)
+            result.back().second = std::max(result.back().second, last);
+        else
+            result.emplace_back(first, last);
+    }
+    return result;
+}
+
+CharSet complement(const CharSet& set) {
+    CharSet result;
+    char32_t next = 0;
+    for(const auto& [first, last]: set) {
+        if(first > next) result.emplace_back(next, first - 1);
+        next = last + 1;
+    }
+    if(next <= maxCodePoint) result.emplace_back(next, maxCodePoint);
+    return result;
+}
+
+CharSet subtract(const CharSet& set, const CharSet& removed) {
+    // A - B = не (не A или B)
+    CharSet unionSet = complement(set);
+    unionSet.insert(unionSet.end(), removed.begin(), removed.end());
+    return complement(normalized(std::move(unionSet)));
+}
+
+// Блоки Unicode для \p{IsX}
+struct Block {
+    string_view name;
+    char32_t first;
+    char32_t last;
+};
+
+constexpr Block blocks[]{
+    {"BasicLatin",               0x0000, 0x007F},
+    {"Latin-1Supplement",        0x0080, 0x00FF},
+    {"LatinExtended-A",          0x0100, 0x017F},
+    {"LatinExtended-B",          0x0180, 0x024F},
+    {"IPAExtensions",            0x0250, 0x02AF},
+    {"SpacingModifierLetters",   0x02B0, 0x02FF},
+    {"CombiningDiacriticalMarks", 0x0300, 0x036F},
+    {"Greek",                    0x0370, 0x03FF},
+    {"GreekandCoptic",           0x0370, 0x03FF},
+    {"Cyrillic",                 0x0400, 0x04FF},
+    {"CyrillicSupplement",       0x0500, 0x052F},
+    {"Armenian",                 0x0530, 0x058F},
+    {"Hebrew",                   0x0590, 0x05FF},
+    {"Arabic",                   0x0600, 0x06FF},
+    {"GeneralPunctuation",       0x2000, 0x206F},
+    {"CurrencySymbols",          0x20A0, 0x20CF},
+    {"LetterlikeSymbols",        0x2100, 0x214F},
+    {"NumberForms",              0x2150, 0x218F},
+    {"Arrows",                   0x2190, 0x21FF},
+    {"MathematicalOperators",    0x2200, 0x22FF},
+    {"BoxDrawing",               0x2500, 0x257F},
+    {"CJKUnifiedIdeographs",     0x4E00, 0x9FFF},
+    {"PrivateUse",               0xE000, 0xF8FF},
+    {"AlphabeticPresentationForms", 0xFB00, 0xFB4F},
+    {"HalfwidthandFullwidthForms", 0xFF00, 0xFFEF},
+    {"Specials",                 0xFFF0, 0xFFFF},
+};
+
+// Выражение шаблона после разбора
+struct Node {
+    enum class Type {
+        Set,    // Один символ из множества
+        Concat, // Последовательность
+        Alt,    // Альтернатива
+        Repeat, // Повторение {min,max}, max = -1 - без ограничения
+    };
+    Type type{Type::Concat};
+    CharSet set{};
+    vector<Node> children{};
+    int min{0};
+    int max{0};
+};
+
+// Разбор регулярных выражений XSD (XML Schema Part 2, приложение F)
+class PatternParser {
+public:
+    explicit PatternParser(string_view pattern)
+        : pattern_{pattern} { }
+
+    Node parse() {
+        Node node = regExp();
+        if(pos_ != pattern_.size()) fail("лишний символ");
+        return node;
+    }
+
+private:
+    [[noreturn]] void fail(string_view what) const {
+        throw std::runtime_error(std::format("{} в позиции {}", what, pos_));
+    }
+
+    bool atEnd() const { return pos_ >= pattern_.size(); }
+    bool peek(char c) const { return !atEnd() && pattern_[pos_] == c; }
+
+    // Следующая кодовая точка UTF-8
+    char32_t next() {
+        if(atEnd()) fail("неожиданный конец шаблона");
+        const auto lead = static_cast<unsigned char>(pattern_[pos_++]);
+        if(lead < 0x80) return lead;
+        const int extra = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : 1;
+        char32_t cp = lead & (0x3F >> extra);
+        for(int i = 0; i < extra; ++i) {
+            if(atEnd()) fail("некорректный UTF-8");
+            cp = (cp << 6) | (static_cast<unsigned char>(pattern_[pos_++]) & 0x3F);
+        }
+        return cp;
+    }
+
+    Node regExp() {
+        Node alt{.type = Node::Type::Alt};
+        alt.children.push_back(branch());
+        while(peek('|')) {
+            ++pos_;
+            alt.children.push_back(branch());
+        }
+        return alt.children.size() == 1 ? std::move(alt.children.front()) : alt;
+    }
+
+    Node branch() {
+        Node concat{.type = Node::Type::Concat};
+        while(!atEnd() && !peek('|') && !peek(')')) {
+            concat.children.push_back(piece());
+        }
+        return concat;
+    }
+
+    Node piece() {
+        Node node = atom();
+        int min = 1, max = 1;
+        if(peek('?')) {
+            ++pos_, min = 0;
+        } else if(peek('*')) {
+            ++pos_, min = 0, max = -1;
+        } else if(peek('+')) {
+            ++pos_, max = -1;
+        } else if(peek('{')) {
+            ++pos_;
+            min = number();
+            max = min;
+            if(peek(',')) {
+                ++pos_;
+                max = peek('}') ? -1 : number();
+            }
+            if(!peek('}')) fail("ожидается }");
+            ++pos_;
+            if(max >= 0 && max < min) fail("неверный квантификатор");
+        } else {
+            return node;
+        }
+        Node repeat{.type = Node::Type::Repeat, .min = min, .max = max};
+        repeat.children.push_back(std::move(node));
+        return repeat;
+    }
+
+    int number() {
+        int value = 0;
+        const size_t start = pos_;
+        while(!atEnd() && isdigit(static_cast<unsigned char>(pattern_[pos_]))) {
+            value = value * 10 + (pattern_[pos_++] - '0');
+            if(value > maxRepeat) fail("слишком большое число повторений");
+        }
+        if(pos_ == start) fail("ожидается число");
+        return value;
+    }
+
+    Node atom() {
+        if(peek('(')) {
+            ++pos_;
+            Node node = regExp();
+            if(!peek(')')) fail("ожидается )");
+            ++pos_;
+            return node;
+        }
+        if(peek('[')) return Node{.type = Node::Type::Set, .set = charClassExpr()};
+        if(peek('.')) {
+            ++pos_;
+            return Node{.type = Node::Type::Set, .set = complement({{'\n', '\n'}, {'\r', '\r'}})};
+        }
+        if(peek('\\')) return Node{.type = Node::Type::Set, .set = escape()};
+        const char32_t c = next();
+        if(c == '?' || c == '*' || c == '+' || c == '{' || c == '}' || c == ']') fail("неэкранированный метасимвол");
+        return Node{.type = Node::Type::Set, .set = {{c, c}}};
+    }
+
+    // [группа] или [^группа], с необязательным вычитанием -[...]
+    CharSet charClassExpr() {
+        ++pos_; // [
+        const bool negative = peek('^');
+        if(negative) ++pos_;
+
+        CharSet set;
+        bool first = true;
+        while(true) {
+            if(atEnd()) fail("ожидается ]");
+            if(peek(']') && !first) break;
+            if(peek('-') && pos_ + 1 < pattern_.size() && pattern_[pos_ + 1] == '[') {
+                ++pos_;
+                const CharSet removed = charClassExpr();
+                set = normalized(std::move(set));
+                set = subtract(negative ? complement(set) : set, removed);
+                if(!peek(']')) fail("ожидается ] после вычитания");
+                ++pos_;
+                return set;
+            }
+            first = false;
+            if(peek('\\')) {
+                const size_t start = pos_;
+                CharSet escaped = escape();
+                // Одиночный экранированный символ может быть началом диапазона
+                if(escaped.size() == 1 && escaped[0].first == escaped[0].second && pos_ - start == 2
+                    && peek('-') && pos_ + 1 < pattern_.size() && pattern_[pos_ + 1] != '[' && pattern_[pos_ + 1] != ']') {
+                    ++pos_;
+                    const char32_t last = rangeEnd();
+                    if(last < escaped[0].first) fail("неверный диапазон");
+                    set.emplace_back(escaped[0].first, last);
+                } else {
+                    set.insert(set.end(), escaped.begin(), escaped.end());
+                }
+                continue;
+            }
+            const char32_t c = next();
+            if(peek('-') && pos_ + 1 < pattern_.size() && pattern_[pos_ + 1] != '[' && pattern_[pos_ + 1] != ']') {
+                ++pos_;
+                const char32_t last = rangeEnd();
+                if(last < c) fail("неверный диапазон");
+                set.emplace_back(c, last);
+            } else {
+                set.emplace_back(c, c);
+            }
+        }
+        ++pos_; // ]
+        set = normalized(std::move(set));
+        return negative ? complement(set) : set;
+    }
+
+    char32_t rangeEnd() {
+        if(!peek('\\')) return next();
+        const CharSet escaped = escape();
+        if(escaped.size() != 1 || escaped[0].first != escaped[0].second) fail("класс в границе диапазона");
+        return escaped[0].first;
+    }
+
+    CharSet escape() {
+        ++pos_; // обратная косая черта
+        const char32_t c = next();
+        switch(c) {
+        case 'n': return {{'\n', '\n'}};
+        case 'r': return {{'\r', '\r'}};
+        case 't': return {{'\t', '\t'}};
+        case 's': return space();
+        case 'S': return complement(space());
+        case 'd': return digit();
+        case 'D': return complement(digit());
+        case 'i': return initial();
+        case 'I': return complement(initial());
+        case 'c': return nameChar();
+        case 'C': return complement(nameChar());
+        case 'w': return word();
+        case 'W': return complement(word());
+        case 'p': return property();
+        case 'P': return complement(property());
+        }
+        if(c < 0x80 && "\\|.-^?*+{}()[]"sv.contains(static_cast<char>(c))) return {{c, c}};
+        fail("неизвестная escape-последовательность");
+    }
+
+    static CharSet space() { return normalized({{' ', ' '}, {'\t', '\t'}, {'\n', '\n'}, {'\r', '\r'}}); }
+    // \d - только ASCII-цифры; остальные цифры Unicode (\p{Nd}) не поддерживаются
+    static CharSet digit() { return {{'0', '9'}}; }
+    // \i и \c - приближение NameStartChar/NameChar XML: вне ASCII допускаются буквы Latin-1 и всё, начиная с U+0100
+    static CharSet initial() {
+        return normalized({{':', ':'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}, {0xC0, 0xD6}, {0xD8, 0xF6}, {0xF8, maxCodePoint}});
+    }
+    static CharSet nameChar() {
+        CharSet set = initial();
+        set.insert(set.end(), {{'-', '.'}, {'0', '9'}, {0xB7, 0xB7}});
+        return normalized(std::move(set));
+    }
+    // \w - всё, кроме пунктуации, разделителей и управляющих символов; вне ASCII - приближение
+    static CharSet word() {
+        return normalized({{'$', '$'}, {'+', '+'}, {'0', '9'}, {'<', '>'}, {'A', 'Z'}, {'^', '^'}, {'`', 'z'}, {'|', '|'},
+            {'~', '~'}, {0xA1, maxCodePoint}});
+    }
+
+    // \p{IsБлок}; категории Unicode (\p{L} и т.п.) не поддерживаются
+    CharSet property() {
+        if(!peek('{')) fail("ожидается {");
+        const size_t close = pattern_.find('}', pos_);
+        if(close == string_view::npos) fail("ожидается }");
+        const string_view name = pattern_.substr(pos_ + 1, close - pos_ - 1);
+        pos_ = close + 1;
+        if(name.starts_with("Is")) {
+            for(const auto& block: blocks) {
+                if(block.name == name.substr(2)) return {{block.first, block.last}};
+            }
+        }
+        throw std::runtime_error(std::format("свойство \\p{{{}}} не поддерживается", name));
+    }
+
+    string_view pattern_;
+    size_t pos_{};
+};
+
+// Недетерминированный автомат Томпсона
+struct Nfa {
+    struct State {
+        vector<std::pair<CharSet, int>> edges; // Переходы по символу
+        vector<int> epsilon;                   // Пустые переходы
+    };
+    vector<State> states;
+
+    int add() {
+        states.emplace_back();
+        return static_cast<int>(states.size()) - 1;
+    }
+
+    // Фрагмент от start до end; возвращает конечное состояние
+    int build(const Node& node, int start) {
+        switch(node.type) {
+        case Node::Type::Set: {
+            const int end = add();
+            states[start].edges.emplace_back(node.set, end);
+            return end;
+        }
+        case Node::Type::Concat: {
+            for(const auto& child: node.children) start = build(child, start);
+            return start;
+        }
+        case Node::Type::Alt: {
+            const int end = add();
+            for(const auto& child: node.children) {
+                const int branch = add();
+                states[start].epsilon.push_back(branch);
+                states[build(child, branch)].epsilon.push_back(end);
+            }
+            return end;
+        }
+        case Node::Type::Repeat: {
+            const Node& child = node.children.front();
+            for(int i = 0; i < node.min; ++i) start = build(child, start);
+            if(node.max < 0) {
+                // Цикл: start -> тело -> start
+                const int loop = add();
+                states[start].epsilon.push_back(loop);
+                const int bodyEnd = build(child, loop);
+                states[bodyEnd].epsilon.push_back(loop);
+                return loop;
+            }
+            const int end = add();
+            for(int i = node.min; i < node.max; ++i) {
+                states[start].epsilon.push_back(end);
+                start = build(child, start);
+            }
+            states[start].epsilon.push_back(end);
+            return end;
+        }
+        }
+        return start;
+    }
+
+    void closure(std::set<int>& set) const {
+        vector<int> stack(set.begin(), set.end());
+        while(!stack.empty()) {
+            const int state = stack.back();
+            stack.pop_back();
+            for(int next: states[state].epsilon) {
+                if(set.insert(next).second) stack.push_back(next);
+            }
+        }
+    }
+};
+
+// Детерминированный автомат: состояние 0 - начальное
+struct Dfa {
+    struct Transition {
+        char32_t first;
+        char32_t last;
+        int target;
+    };
+    vector<vector<Transition>> states;
+    vector<bool> accepting;
+};
+
+// Построение подмножеств; переходы разбиваются на непересекающиеся диапазоны
+Dfa compilePattern(string_view pattern) {
+    Nfa nfa;
+    const int start = nfa.add();
+    const int accept = nfa.build(PatternParser{pattern}.parse(), start);
+
+    Dfa dfa;
+    std::map<std::set<int>, int> index;
+    vector<std::set<int>> pending;
+
+    auto stateOf = [&](std::set<int> set) {
+        nfa.closure(set);
+        auto [it, inserted] = index.emplace(set, static_cast<int>(dfa.states.size()));
+        if(inserted) {
+            if(dfa.states.size() >= maxDfaStates) throw std::runtime_error("слишком много состояний автомата");
+            dfa.states.emplace_back();
+            dfa.accepting.push_back(set.contains(accept));
+            pending.push_back(std::move(set));
+        }
+        return it->second;
+    };
+
+    stateOf({start});
+    for(size_t current = 0; current < pending.size(); ++current) {
+        const std::set<int> set = pending[current];
+
+        // Границы диапазонов всех переходов подмножества
+        vector<char32_t> bounds;
+        for(int state: set) {
+            for(const auto& [chars, target]: nfa.states[state].edges) {
+                for(const auto& [first, last]: chars) {
+                    bounds.push_back(first);
+                    bounds.push_back(last + 1);
+                }
+            }
+        }
+        std::ranges::sort(bounds);
+        bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+        for(size_t i = 0; i + 1 < bounds.size(); ++i) {
+            const char32_t first = bounds[i];
+            const char32_t last = bounds[i + 1] - 1;
+            std::set<int> targets;
+            for(int state: set) {
+                for(const auto& [chars, target]: nfa.states[state].edges) {
+                    const bool covered = std::ranges::any_of(chars, [&](const auto& range) {
+                        return range.first <= first && last <= range.second;
+                    });
+                    if(covered) targets.insert(target);
+                }
+            }
+            if(targets.empty()) continue;
+            const int target = stateOf(std::move(targets));
+            auto& transitions = dfa.states[current];
+            if(!transitions.empty() && transitions.back().target == target && transitions.back().last + 1 == first)
+                transitions.back().last = last;
+            else
+                transitions.push_back({first, last, target});
+        }
+    }
+
+    return dfa;
+}
+
+// Шаги от состояния до ближайшего допускающего; INT_MAX - недостижимо
+vector<int> acceptDistance(const Dfa& dfa) {
+    vector<int> distance(dfa.states.size(), INT_MAX);
+    for(size_t state = 0; state < dfa.states.size(); ++state) {
+        if(dfa.accepting[state]) distance[state] = 0;
+    }
+    for(bool changed = true; changed;) {
+        changed = false;
+        for(size_t state = 0; state < dfa.states.size(); ++state) {
+            for(const auto& transition: dfa.states[state]) {
+                const int via = distance[transition.target];
+                if(via != INT_MAX && via + 1 < distance[state]) distance[state] = via + 1, changed = true;
+            }
+        }
+    }
+    return distance;
+}
+
+// Случайная кодовая точка диапазона, допустимая в XML; печатные ASCII предпочтительнее
+std::optional<char32_t> pickCodePoint(char32_t first, char32_t last, std::mt19937_64& random) {
+    constexpr std::pair<char32_t, char32_t> allowed[]{
+        {0x21,    0x7E    },
+        {0x20,    0x20    },
+        {0xA0,    0xD7FF  },
+        {0xE000,  0xFFFD  },
+        {0x10000, 0x10FFFF},
+    };
+    for(const auto& [low, high]: allowed) {
+        const char32_t from = std::max(first, low);
+        const char32_t to = std::min(last, high);
+        if(from <= to) return std::uniform_int_distribution<char32_t>{from, to}(random);
+    }
+    return std::nullopt;
+}
+
+void appendUtf8(string& text, char32_t cp) {
+    if(cp < 0x80) {
+        text += static_cast<char>(cp);
+    } else if(cp < 0x800) {
+        text += static_cast<char>(0xC0 | cp >> 6);
+        text += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if(cp < 0x10000) {
+        text += static_cast<char>(0xE0 | cp >> 12);
+        text += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+        text += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        text += static_cast<char>(0xF0 | cp >> 18);
+        text += static_cast<char>(0x80 | (cp >> 12 & 0x3F));
+        text += static_cast<char>(0x80 | (cp >> 6 & 0x3F));
+        text += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+bool accepts(const Dfa& dfa, const std::u32string& text) {
+    int state = 0;
+    for(char32_t cp: text) {
+        auto it = std::ranges::find_if(dfa.states[state], [cp](const auto& transition) {
+            return transition.first <= cp && cp <= transition.last;
+        });
+        if(it == dfa.states[state].end()) return false;
+        state = it->target;
+    }
+    return dfa.accepting[state];
+}
+
+} // namespace
+
+// Автомат шаблона и расстояния до допускающих состояний
+struct StringSampler::Automaton {
+    Dfa dfa;
+    vector<int> distance;
+};
+
+StringSampler::StringSampler() = default;
+StringSampler::~StringSampler() = default;
+
+const StringSampler::Automaton* StringSampler::automaton(const string& pattern) {
+    auto it = automata_.find(pattern);
+    if(it == automata_.end()) {
+        std::unique_ptr<Automaton> compiled;
+        try {
+            compiled = std::make_unique<Automaton>();
+            compiled->dfa = compilePattern(pattern);
+            compiled->distance = acceptDistance(compiled->dfa);
+        } catch(const std::exception&) {
+            compiled.reset(); // Шаблон не поддерживается - строка без шаблона
+        }
+        it = automata_.emplace(pattern, std::move(compiled)).first;
+    }
+    return it->second.get();
+}
+
+// Случайный путь по автомату последнего шаблона до допускающего состояния;
+// остальные шаблоны и длина проверяются, при несоответствии - новая попытка
+std::optional<string> StringSampler::sample(const Facets& facets, std::mt19937_64& random) {
+    const int minLength = facets.length >= 0 ? facets.length : std::max(facets.minLength, 0);
+    const int maxLength = facets.length >= 0 ? facets.length : facets.maxLength; // -1 - не ограничена
+    if(maxLength >= 0 && minLength > maxLength) return std::nullopt;
+    std::uniform_int_distribution lengths{minLength, maxLength >= 0 ? maxLength : std::max(minLength, 16)};
+
+    vector<const Automaton*> automata;
+    for(const auto& pattern: facets.patterns) {
+        if(const Automaton* compiled = automaton(pattern)) automata.push_back(compiled);
+    }
+
+    for(int attempt = 0; attempt < 32; ++attempt) {
+        std::u32string text;
+        if(automata.empty()) {
+            const int length = lengths(random);
+            for(int i = 0; i < length; ++i) text += std::uniform_int_distribution<char32_t>{'a', 'z'}(random);
+        } else {
+            const Automaton& walk = *automata.back();
+            const int length = lengths(random);
+            int state = 0;
+            while(text.size() < 256) {
+                const auto& transitions = walk.dfa.states[state];
+                if(walk.dfa.accepting[state] && (static_cast<int>(text.size()) >= length || transitions.empty())) break;
+                // Набрав длину, идём кратчайшим путём к допускающему состоянию
+                vector<const Dfa::Transition*> choices;
+                for(const auto& transition: transitions) {
+                    const int distance = walk.distance[transition.target];
+                    if(distance == INT_MAX) continue;
+                    if(static_cast<int>(text.size()) >= length && distance >= walk.distance[state]) continue;
+                    choices.push_back(&transition);
+                }
+                std::optional<char32_t> cp;
+                while(!choices.empty() && !cp) {
+                    const size_t index = std::uniform_int_distribution<size_t>{0, choices.size() - 1}(random);
+                    cp = pickCodePoint(choices[index]->first, choices[index]->last, random);
+                    if(cp) state = choices[index]->target;
+                    else choices.erase(choices.begin() + index);
+                }
+                if(!cp) break;
+                text += *cp;
+            }
+            if(!walk.dfa.accepting[state]) continue;
+        }
+
+        const int size = static_cast<int>(text.size());
+        if(size < minLength || (maxLength >= 0 && size > maxLength)) continue;
+        if(!std::ranges::all_of(automata, [&](const Automaton* other) { return accepts(other->dfa, text); })) continue;
+
+        string result;
+        for(char32_t cp: text) appendUtf8(result, cp);
+        return result;
+    }
+    return std::nullopt;
+}
+
+namespace {
+
+////////////////////////////////////////
+// Генерация Validate.h/Validate.cpp
+
+// Проверки во время выполнения (Validate.cpp)
+constexpr auto runtimeDefinition = R"(namespace {
+
+// Переход автомата по диапазону кодовых точек
+struct Transition {
+    char32_t first;
+    char32_t last;
+    std::uint16_t target;
+};
+
+// Автомат шаблона, построенный при генерации; состояние 0 - начальное
+struct Dfa {
+    const std::uint32_t* offsets; // Переходы состояния s: [offsets[s], offsets[s + 1]); их бывает больше 65535
+    const Transition* transitions;
+    const bool* accepting;
+};
+
+// Следующая кодовая точка UTF-8; false - некорректная последовательность
+[[maybe_unused]] bool nextCodePoint(std::string_view& text, char32_t& cp) {
+    const auto lead = static_cast<unsigned char>(text[0]);
+    const std::size_t size = lead < 0x80 ? 1 : lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 0;
+    if(size == 0 || size > text.size()) return false;
+    cp = size == 1 ? lead : lead & (0x7F >> size);
+    for(std::size_t i = 1; i < size; ++i) {
+        const auto byte = static_cast<unsigned char>(text[i]);
+        if((byte & 0xC0) != 0x80) return false;
+        cp = (cp << 6) | (byte & 0x3F);
+    }
+    text.remove_prefix(size);
+    return true;
+}
+
+// Соответствие всей строки шаблону за один проход
+[[maybe_unused]] bool matches(const Dfa& dfa, std::string_view text) {
+    std::uint16_t state = 0;
+    char32_t cp;
+    while(!text.empty()) {
+        if(!nextCodePoint(text, cp)) return false;
+        const Transition* it = dfa.transitions + dfa.offsets[state];
+        const Transition* end = dfa.transitions + dfa.offsets[state + 1];
+        while(it != end && it->last < cp) ++it;
+        if(it == end || it->first > cp) return false;
+        state = it->target;
+    }
+    return dfa.accepting[state];
+}
+
+// Длина строки в символах (xs:length считает кодовые точки, а не байты)
+[[maybe_unused]] std::size_t codePoints(std::string_view text) {
+    std::size_t count = 0;
+    for(char c: text) count += (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+    return count;
+}
+
+// Путь к дочернему значению: /name, /@name или /name[index]
+[[maybe_unused]] void report(Violations& violations, const std::string& path, std::string_view name, const char* error) {
+    violations.push_back({path + '/' + std::string{name}, error});
+}
+
+)"sv;
+
+// Строковый литерал C++
+string quoted(string_view text) {
+    string result = "\"";
+    for(char c: text) {
+        if(c == '\\' || c == '"') result += '\\';
+        result += c;
+    }
+    return result + '"';
+}
+
+bool isNumber(const string& text) {
+    double value;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc{} && end == text.data() + text.size();
+}
+
+// Граница диапазона числового поля
+struct Bound {
+    string_view facet;
+    string_view violation; // Сравнение, при котором значение выходит за границу
+    const string* value;
+};
+
+// Проверяемые границы: пропускаются нечисловые и те, что тип хранения и так не позволяет нарушить
+// (minInclusive 0 у uint8_t)
+vector<Bound> scalarBounds(const Field& field, bool warn = false) {
+    const Facets& facets = field.facets;
+    const Bound all[]{
+        {"minInclusive", "<",  &facets.minInclusive},
+        {"maxInclusive", ">",  &facets.maxInclusive},
+        {"minExclusive", "<=", &facets.minExclusive},
+        {"maxExclusive", ">=", &facets.maxExclusive},
+    };
+
+    vector<Bound> bounds;
+    if(field.type == "bool") return bounds;
+    const IntegerType* integer = IntegerType::find(field.type);
+    for(const auto& bound: all) {
+        const string& text = *bound.value;
+        if(text.empty()) continue;
+        if(!isNumber(text)) {
+            if(warn) println(std::cout, "  Предупреждение: граница {} {} поля {} не проверяется", bound.facet, text, field.name);
+            continue;
+        }
+        int64_t value;
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if(integer && ec == std::errc{} && end == text.data() + text.size()) {
+            const auto above = [&](uint64_t limit) { return value >= 0 && static_cast<uint64_t>(value) >= limit; };
+            if(bound.facet == "minInclusive" && value <= integer->min) continue;
+            if(bound.facet == "minExclusive" && value < integer->min) continue;
+            if(bound.facet == "maxInclusive" && above(integer->max)) continue;
+            if(bound.facet == "maxExclusive" && integer->max < UINT64_MAX && above(integer->max + 1)) continue;
+        }
+        bounds.push_back(bound);
+    }
+    return bounds;
+}
+
+// Имя набора фасетов поля: простой тип или Владелец_поле
+string facetsName(const string& owner, const Field& field) {
+    return field.facets.name.empty() ? owner + "_" + field.name : field.facets.name;
+}
+
+// Есть ли у поля проверяемые для его категории фасеты.
+// Шаблоны проверяются только у строк: числа и логические значения уже разобраны при загрузке
+bool hasChecks(const Field& field) {
+    const Facets& facets = field.facets;
+    switch(field.kind) {
+    case Field::Kind::String:
+        return !facets.patterns.empty() || facets.length >= 0 || facets.minLength >= 0 || facets.maxLength >= 0;
+    case Field::Kind::Binary: return facets.length >= 0 || facets.minLength >= 0 || facets.maxLength >= 0;
+    case Field::Kind::Scalar: return !scalarBounds(field).empty();
+    default: return false;
+    }
+}
+
+string argumentType(const Field& field) {
+    switch(field.kind) {
+    case Field::Kind::String: return "std::string_view";
+    case Field::Kind::Binary: return "const std::vector<unsigned char>&";
+    default: return field.type;
+    }
+}
+
+// Код проверки набора фасетов; таблицы автоматов шаблонов - в tables
+string generateCheck(const Field& field, const string& name, std::stringstream& tables, int& patternCount) {
+    const Facets& facets = field.facets;
+    std::stringstream ss;
+
+    println(ss, "const char* check{}({} value) {{", name, argumentType(field));
+
+    if(field.kind == Field::Kind::String) {
+        for(const auto& pattern: facets.patterns) {
+            Dfa dfa;
+            try {
+                dfa = compilePattern(pattern);
+            } catch(const std::exception& e) {
+                println(std::cout, "  Предупреждение: шаблон {} типа {} не проверяется: {}", pattern, name, e.what());
+                continue;
+            }
+
+            const int id = patternCount++;
+            println(tables, "// {}", pattern);
+            println(tables, "constexpr std::uint32_t pattern{}Offsets[]{{", id);
+            size_t offset = 0;
+            string offsets;
+            for(const auto& state: dfa.states) {
+                offsets += std::to_string(offset) + ", ";
+                offset += state.size();
+            }
+            println(tables, "    {}{},", offsets, offset);
+            println(tables, "}};");
+            println(tables, "constexpr Transition pattern{}Transitions[]{{", id);
+            for(const auto& state: dfa.states) {
+                for(const auto& [first, last, target]: state) {
+                    println(tables, "    {{{:#x}, {:#x}, {}}},", static_cast<uint32_t>(first), static_cast<uint32_t>(last), target);
+                }
+            }
+            if(offset == 0) println(tables, "    {{1, 0, 0}}, // Нет переходов");
+            println(tables, "}};");
+            string accepting;
+            for(bool state: dfa.accepting) accepting += state ? "true, " : "false, ";
+            println(tables, "constexpr bool pattern{}Accepting[]{{{}}};", id, accepting);
+            println(tables, "constexpr Dfa pattern{0}{{pattern{0}Offsets, pattern{0}Transitions, pattern{0}Accepting}};\n", id);
+
+            println(ss, "    if(!matches(pattern{}, value)) return {};", id, quoted("pattern " + pattern));
+        }
+    }
+
+    if(field.kind == Field::Kind::String || field.kind == Field::Kind::Binary) {
+        const string_view size = field.kind == Field::Kind::String ? "codePoints(value)" : "value.size()";
+        if(facets.length >= 0) {
+            println(ss, "    if({} != {}) return \"length {}\";", size, facets.length, facets.length);
+        }
+        if(facets.minLength >= 0) {
+            println(ss, "    if({} < {}) return \"minLength {}\";", size, facets.minLength, facets.minLength);
+        }
+        if(facets.maxLength >= 0) {
+            println(ss, "    if({} > {}) return \"maxLength {}\";", size, facets.maxLength, facets.maxLength);
+        }
+    }
+
+    if(field.kind == Field::Kind::Scalar) {
+        for(const auto& bound: scalarBounds(field, true)) {
+            println(ss, "    if(value {} {}) return \"{} {}\";", bound.violation, *bound.value, bound.facet, *bound.value);
+        }
+    }
+
+    println(ss, "    return nullptr;");
+    println(ss, "}}\n");
+    return ss.str();
+}
+
+} // namespace
+
+string ComplexType::generateValidateDecl() const {
+    return std::format("void validate(const {}& value, std::string& path, Violations& violations);\n", name);
+}
+
+string ComplexType::generateValidateCode(const std::map<string, bool>& needsValidation) const {
+    std::stringstream ss;
+
+    auto checked = [&](const Field& field) {
+        if(field.kind != Field::Kind::Complex) return hasChecks(field);
+        auto it = needsValidation.find(field.type);
+        return it != needsValidation.end() && it->second;
+    };
+
+    if(!std::ranges::any_of(fields, checked)) {
+        println(ss, "void validate(const {}&, std::string&, Violations&) {{ }}\n", name);
+        return ss.str();
+    }
+
+    println(ss, "void validate(const {}& value, std::string& path, Violations& violations) {{", name);
+    if(std::ranges::any_of(fields, [&](const Field& field) { return field.kind == Field::Kind::Complex && checked(field); })) {
+        println(ss, "    const auto size = path.size();");
+    }
+    for(const auto& field: fields) {
+        if(!checked(field)) continue;
+
+        const string node = field.isText ? "text()" : field.isAttribute ? "@" + field.xmlName : field.xmlName;
+        const bool complex = field.kind == Field::Kind::Complex;
+        const string check = "facets::check" + facetsName(name, field);
+
+        if(field.isRepeated()) {
+            println(ss, "    for(std::size_t i = 0; const auto& item: value.{}) {{", field.name);
+            if(complex) {
+                println(ss, "        path += \"/{}[\" + std::to_string(i++) + ']';", node);
+                println(ss, "        validate(item, path, violations);");
+                println(ss, "        path.resize(size);");
+            } else {
+                println(ss, "        if(auto error = {}(item))", check);
+                println(ss, "            report(violations, path, \"{}[\" + std::to_string(i) + ']', error);", node);
+                println(ss, "        ++i;");
+            }
+            println(ss, "    }}");
+            continue;
+        }
+
+        const string value = field.isOptional ? "*value." + field.name : "value." + field.name;
+        const string indent = field.isOptional ? "        " : "    ";
+        if(field.isOptional) println(ss, "    if(value.{}) {{", field.name);
+        if(complex) {
+            println(ss, "{}path += \"/{}\";", indent, node);
+            println(ss, "{}validate({}, path, violations);", indent, value);
+            println(ss, "{}path.resize(size);", indent);
+        } else {
+            println(ss, "{}if(auto error = {}({})) report(violations, path, \"{}\", error);", indent, check, value, node);
+        }
+        if(field.isOptional) println(ss, "    }}");
+    }
+    println(ss, "}}\n");
+
+    return ss.str();
+}
+
+bool Parser::generateValidator(const string& outputDir, const string& namespaceName) const {
+    // Типы, поддерево которых содержит проверяемые фасеты
+    std::map<string, bool> needsValidation;
+    for(const auto& complexType: complexTypes) {
+        needsValidation[complexType.name] = std::ranges::any_of(complexType.fields, hasChecks);
+    }
+    for(bool changed = true; changed;) {
+        changed = false;
+        for(const auto& complexType: complexTypes) {
+            bool& needs = needsValidation[complexType.name];
+            if(needs) continue;
+            needs = std::ranges::any_of(complexType.fields, [&](const Field& field) {
+                return field.kind == Field::Kind::Complex && needsValidation[field.type];
+            });
+            changed |= needs;
+        }
+    }
+
+    // Наборы фасетов по имени; именованный простой тип проверяется одной функцией для всех полей
+    std::map<string, const Field*> checks;
+    for(const auto& complexType: complexTypes) {
+        for(const auto& field: complexType.fields) {
+            if(hasChecks(field)) checks.emplace(facetsName(complexType.name, field), &field);
+        }
+    }
+
+    std::ofstream header(outputDir + "/Validate.h");
+    if(!header.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Validate.h", outputDir);
+        return false;
+    }
+
+    println(header, "#pragma once\n");
+    println(header, "#include <string>");
+    println(header, "#include <string_view>");
+    println(header, "#include <vector>");
+    println(header, "#include \"Types.h\"\n");
+
+    if(!namespaceName.empty()) {
+        println(header, "namespace {} {{\n", namespaceName);
+    }
+
+    println(header, "// Нарушение фасета схемы: путь к значению и нарушенное ограничение");
+    println(header, "struct Violation {{");
+    println(header, "    std::string path;");
+    println(header, "    std::string message;");
+    println(header, "}};\n");
+    println(header, "using Violations = std::vector<Violation>;\n");
+
+    println(header, "// Проверки простых типов: nullptr - значение допустимо, иначе описание нарушенного фасета");
+    println(header, "namespace facets {{");
+    for(const auto& [name, field]: checks) {
+        println(header, "const char* check{}({} value);", name, argumentType(*field));
+    }
+    println(header, "}} // namespace facets\n");
+
+    for(const auto& complexType: complexTypes) {
+        header << complexType.generateValidateDecl();
+    }
+
+    println(header, "\n// Проверяет документ целиком; пустой результат - все значения соответствуют фасетам");
+    println(header, "template <class T>");
+    println(header, "Violations validate(const T& root, std::string_view tag) {{");
+    println(header, "    Violations violations;");
+    println(header, "    std::string path{{tag}};");
+    println(header, "    validate(root, path, violations);");
+    println(header, "    return violations;");
+    println(header, "}}");
+
+    if(!namespaceName.empty()) {
+        println(header, "\n}} // namespace {}", namespaceName);
+    }
+    header.close();
+
+    std::ofstream source(outputDir + "/Validate.cpp");
+    if(!source.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Validate.cpp", outputDir);
+        return false;
+    }
+
+    // Автоматы строятся при генерации: в Validate.cpp только таблицы переходов
+    std::stringstream tables;
+    std::stringstream functions;
+    int patternCount = 0;
+    for(const auto& [name, field]: checks) {
+        functions << generateCheck(*field, name, tables, patternCount);
+    }
+
+    println(source, "#include \"Validate.h\"");
+    println(source, "#include <cstdint>\n");
+
+    if(!namespaceName.empty()) {
+        println(source, "namespace {} {{\n", namespaceName);
+    }
+
+    source << runtimeDefinition;
+    source << tables.str();
+    println(source, "}} // namespace\n");
+
+    println(source, "namespace facets {{\n");
+    source << functions.str();
+    println(source, "}} // namespace facets\n");
+
+    for(const auto& complexType: complexTypes) {
+        source << complexType.generateValidateCode(needsValidation);
+    }
+
+    if(!namespaceName.empty()) {
+        println(source, "}} // namespace {}", namespaceName);
+    }
+    source.close();
+    return true;
+}
+
+} // namespace Xsd
@@ -0,0 +1,401 @@
+#include "XsdParser.h"
+#include <format>
+#include <iostream>
+#include <sstream>
+
+namespace Xsd {
+
+using std ::println;
+
+namespace {
+
+// Буферизованный приёмник и сериализация значений встроенных типов (Writer.h)
+constexpr auto sinkDeclaration = R"(// Буферизованный приёмник XML без промежуточного DOM.
+// Пишет в файловый дескриптор, сбрасывая буфер по заполнении,
+// либо накапливает документ в растущем буфере (конструктор по умолчанию).
+class XmlSink {
+public:
+    XmlSink() = default;
+    explicit XmlSink(int fd, std::size_t capacity = 1 << 16);
+    explicit XmlSink(const std::string& path, std::size_t capacity = 1 << 16);
+    XmlSink(const XmlSink&) = delete;
+    XmlSink& operator=(const XmlSink&) = delete;
+    ~XmlSink();
+
+    void raw(std::string_view text) {
+        if(fd_ >= 0 && buffer_.size() + text.size() > capacity_) {
+            flush();
+            if(text.size() >= capacity_) return writeFd(text);
+        }
+        buffer_.append(text);
+    }
+    void put(char c) {
+        if(fd_ >= 0 && buffer_.size() >= capacity_) flush();
+        buffer_.push_back(c);
+    }
+    // Экранирует &, <, > (и кавычки/переводы строк в атрибутах) по ходу записи
+    void escaped(std::string_view text, bool attribute);
+
+    void declaration() { raw("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"); }
+    void openTag(std::string_view tag) { put('<'), raw(tag); }
+    void closeStartTag() { put('>'); }
+    void closeEmptyTag() { raw("/>"); }
+    void endTag(std::string_view tag) { raw("</"), raw(tag), put('>'); }
+
+    template <class T>
+    void attribute(std::string_view name, const T& value) {
+        put(' '), raw(name), raw("=\"");
+        writeValue(*this, value, true);
+        put('"');
+    }
+    template <class T>
+    void element(std::string_view tag, const T& value) {
+        openTag(tag), closeStartTag();
+        writeValue(*this, value, false);
+        endTag(tag);
+    }
+
+    // Сбрасывает буфер в дескриптор (в режиме буфера ничего не делает)
+    bool flush();
+    bool ok() const { return ok_; }
+    std::string_view view() const { return buffer_; }
+    std::string take() { return std::move(buffer_); }
+
+private:
+    void writeFd(std::string_view text);
+
+    std::string buffer_;
+    std::size_t capacity_{0};
+    int fd_{-1};
+    bool ownsFd_{false};
+    bool ok_{true};
+};
+
+// std::string и FixedString<N> (Options::inlineStrings)
+inline void writeValue(XmlSink& sink, std::string_view value, bool attribute) {
+    sink.escaped(value, attribute);
+}
+
+inline void writeValue(XmlSink& sink, bool value, bool) {
+    sink.raw(value ? "true" : "false");
+}
+
+template <class T>
+    requires std::is_arithmetic_v<T>
+void writeValue(XmlSink& sink, T value, bool) {
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    sink.raw({buffer, static_cast<std::size_t>(end - buffer)});
+}
+
+template <class E>
+    requires std::is_enum_v<E>
+void writeValue(XmlSink& sink, E value, bool attribute) {
+    sink.escaped(toString(value), attribute);
+}
+
+// hexBinary/base64Binary пишутся в шестнадцатеричном виде
+void writeValue(XmlSink& sink, const std::vector<unsigned char>& value, bool);
+)"sv;
+
+// Сериализация документа целиком (Writer.h, после объявлений writeXml)
+constexpr auto documentHelpers = R"(// Сериализует документ в строку
+template <class T>
+std::string toXml(const T& root, std::string_view tag) {
+    XmlSink sink;
+    sink.declaration();
+    writeXml(sink, root, tag);
+    return sink.take();
+}
+
+// Сериализует документ в файл, возвращает false при ошибке записи
+template <class T>
+bool saveXml(const T& root, std::string_view tag, const std::string& path) {
+    XmlSink sink(path);
+    if(!sink.ok()) return false;
+    sink.declaration();
+    writeXml(sink, root, tag);
+    return sink.flush();
+}
+)"sv;
+
+// Обобщённая сериализация по таблице описаний полей (Writer.h, режим Options::descriptors)
+constexpr auto writeFieldsDeclaration = R"(
+// Сериализует value по meta::Descriptor<T>: атрибуты в открывающий тег, затем содержимое
+template <class T>
+void writeFields(XmlSink& sink, const T& value, std::string_view tag) {
+    sink.openTag(tag);
+    meta::visit(value, [&sink]<class F>(const F& field, const auto& member) {
+        if constexpr(F::node != meta::Node::Attribute) return;
+        else if constexpr(F::occurs == meta::Occurs::Optional) {
+            if(member) sink.attribute(field.name, *member);
+        } else {
+            sink.attribute(field.name, member);
+        }
+    });
+
+    if constexpr(!meta::hasContent<T>()) {
+        sink.closeEmptyTag();
+        return;
+    }
+
+    sink.closeStartTag();
+    meta::visit(value, [&sink]<class F>(const F& field, const auto& member) {
+        // Вложенные структуры сериализуются своими writeXml, простые значения - через element
+        auto write = [&](const auto& item) {
+            if constexpr(F::node == meta::Node::Text) writeValue(sink, item, false);
+            else if constexpr(F::kind == meta::Kind::Complex) writeXml(sink, item, field.name);
+            else sink.element(field.name, item);
+        };
+
+        if constexpr(F::node == meta::Node::Attribute) return;
+        else if constexpr(F::occurs == meta::Occurs::Repeated) {
+            for(const auto& item: member) write(item);
+        } else if constexpr(F::occurs == meta::Occurs::Optional) {
+            if(member) write(*member);
+        } else {
+            write(member);
+        }
+    });
+    sink.endTag(tag);
+}
+)"sv;
+
+// Реализация XmlSink (Writer.cpp)
+constexpr auto sinkDefinition = R"(XmlSink::XmlSink(int fd, std::size_t capacity)
+    : capacity_{capacity}
+    , fd_{fd} {
+    buffer_.reserve(capacity_);
+}
+
+XmlSink::XmlSink(const std::string& path, std::size_t capacity)
+    : capacity_{capacity}
+    , fd_{openFile(path)}
+    , ownsFd_{true}
+    , ok_{fd_ >= 0} {
+    buffer_.reserve(capacity_);
+}
+
+XmlSink::~XmlSink() {
+    if(fd_ < 0) return;
+    flush();
+    if(ownsFd_) closeFile(fd_);
+}
+
+bool XmlSink::flush() {
+    if(fd_ >= 0 && !buffer_.empty()) {
+        writeFd(buffer_);
+        buffer_.clear();
+    }
+    return ok_;
+}
+
+void XmlSink::writeFd(std::string_view text) {
+    while(ok_ && !text.empty()) {
+        auto written = writeFile(fd_, text.data(), text.size());
+        // Запись, прерванная сигналом до передачи данных, повторяется
+        if(written < 0 && errno == EINTR) continue;
+        if(written <= 0) {
+            ok_ = false;
+            break;
+        }
+        text.remove_prefix(static_cast<std::size_t>(written));
+    }
+}
+
+void XmlSink::escaped(std::string_view text, bool attribute) {
+    std::size_t start = 0;
+    for(std::size_t i = 0; i < text.size(); ++i) {
+        std::string_view entity;
+        switch(text[i]) {
+        case '<': entity = "&lt;"; break;
+        case '>': entity = "&gt;"; break;
+        case '&': entity = "&amp;"; break;
+        case '"': if(attribute) entity = "&quot;"; break;
+        case '\n': if(attribute) entity = "&#10;"; break;
+        case '\t': if(attribute) entity = "&#9;"; break;
+        case '\r': entity = "&#13;"; break;
+        default: break;
+        }
+        if(entity.empty()) continue;
+        raw(text.substr(start, i - start));
+        raw(entity);
+        start = i + 1;
+    }
+    raw(text.substr(start));
+}
+
+void writeValue(XmlSink& sink, const std::vector<unsigned char>& value, bool) {
+    constexpr char digits[] = "0123456789ABCDEF";
+    for(unsigned char byte: value) {
+        sink.put(digits[byte >> 4]);
+        sink.put(digits[byte & 0xF]);
+    }
+}
+)"sv;
+
+// Обёртки над системными вызовами (Writer.cpp, до пространства имён)
+constexpr auto fileFunctions = R"(#include <cerrno>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+
+namespace {
+int openFile(const std::string& path) { return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644); }
+int writeFile(int fd, const char* data, std::size_t size) { return _write(fd, data, static_cast<unsigned>(size)); }
+void closeFile(int fd) { _close(fd); }
+} // namespace
+#else
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+int openFile(const std::string& path) { return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644); }
+ssize_t writeFile(int fd, const char* data, std::size_t size) { return ::write(fd, data, size); }
+void closeFile(int fd) { ::close(fd); }
+} // namespace
+#endif
+)"sv;
+
+} // namespace
+
+string ComplexType::generateWriterDecl() const {
+    return std::format("void writeXml(XmlSink& sink, const {}& value, std::string_view tag);\n", name);
+}
+
+string ComplexType::generateWriterCode(const Options& options) const {
+    std::stringstream ss;
+
+    // У структуры без полей value не используется
+    println(ss, "void writeXml(XmlSink& sink, {}const {}& value, std::string_view tag) {{",
+        fields.empty() && !options.descriptors ? "[[maybe_unused]] " : "", name);
+
+    // Тело строится шаблоном writeFields по таблице описаний
+    if(options.descriptors) {
+        println(ss, "    writeFields(sink, value, tag);");
+        println(ss, "}}\n");
+        return ss.str();
+    }
+    println(ss, "    sink.openTag(tag);");
+
+    // Атрибуты пишутся в открывающий тег, поэтому идут первыми
+    for(const auto& field: fields) {
+        if(!field.isAttribute) continue;
+        if(field.isOptional)
+            println(ss, "    if(value.{0}) sink.attribute(\"{1}\", *value.{0});", field.name, field.xmlName);
+        else
+            println(ss, "    sink.attribute(\"{1}\", value.{0});", field.name, field.xmlName);
+    }
+
+    const bool hasContent = std::ranges::any_of(fields, [](const Field& field) { return !field.isAttribute; });
+    if(!hasContent) {
+        println(ss, "    sink.closeEmptyTag();");
+        println(ss, "}}\n");
+        return ss.str();
+    }
+
+    println(ss, "    sink.closeStartTag();");
+
+    for(const auto& field: fields) {
+        if(field.isAttribute) continue;
+
+        // Текстовое содержимое simpleContent/mixed
+        if(field.isText) {
+            if(field.isOptional)
+                println(ss, "    if(value.{0}) writeValue(sink, *value.{0}, false);", field.name);
+            else
+                println(ss, "    writeValue(sink, value.{}, false);", field.name);
+            continue;
+        }
+
+        // Вложенные структуры сериализуются своими writeXml, простые значения - через element
+        auto write = [&](string_view item) {
+            return field.kind == Field::Kind::Complex
+                ? std::format("writeXml(sink, {}, \"{}\");", item, field.xmlName)
+                : std::format("sink.element(\"{}\", {});", field.xmlName, item);
+        };
+
+        if(field.isRepeated())
+            println(ss, "    for(const auto& item: value.{}) {}", field.name, write("item"));
+        else if(field.isOptional)
+            println(ss, "    if(value.{0}) {1}", field.name, write("*value." + field.name));
+        else
+            println(ss, "    {}", write("value." + field.name));
+    }
+
+    println(ss, "    sink.endTag(tag);");
+    println(ss, "}}\n");
+
+    return ss.str();
+}
+
+bool Parser::generateWriter(const string& outputDir, const string& namespaceName) const {
+    std::ofstream header(outputDir + "/Writer.h");
+    if(!header.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Writer.h", outputDir);
+        return false;
+    }
+
+    println(header, "#pragma once\n");
+    println(header, "#include <charconv>");
+    println(header, "#include <cstddef>");
+    println(header, "#include <string>");
+    println(header, "#include <string_view>");
+    println(header, "#include <type_traits>");
+    println(header, "#include <vector>");
+    if(options_.leanHeaders) {
+        println(header, "#include \"Enums_io.h\"");
+    }
+    println(header, "#include \"{}\"\n", options_.descriptors ? "Descriptors.h" : "Types.h");
+
+    if(!namespaceName.empty()) {
+        println(header, "namespace {} {{\n", namespaceName);
+    }
+
+    header << sinkDeclaration << '\n';
+
+    for(const auto& complexType: complexTypes) {
+        header << complexType.generateWriterDecl();
+    }
+
+    if(options_.descriptors) {
+        header << writeFieldsDeclaration;
+    }
+
+    header << '\n'
+           << documentHelpers;
+
+    if(!namespaceName.empty()) {
+        println(header, "\n}} // namespace {}", namespaceName);
+    }
+
+    header.close();
+
+    std::ofstream source(outputDir + "/Writer.cpp");
+    if(!source.is_open()) {
+        println(std::cerr, "Не удалось создать файл: {}/Writer.cpp", outputDir);
+        return false;
+    }
+
+    println(source, "#include \"Writer.h\"\n");
+    source << fileFunctions << '\n';
+
+    if(!namespaceName.empty()) {
+        println(source, "namespace {} {{\n", namespaceName);
+    }
+
+    source << sinkDefinition << '\n';
+
+    for(const auto& complexType: complexTypes) {
+        source << complexType.generateWriterCode(options_);
+    }
+
+    if(!namespaceName.empty()) {
+        println(source, "}} // namespace {}", namespaceName);
+    }
+
+    source.close();
+    return true;
+}
+
+} // namespace Xsd
@@ -1,7 +1,44 @@
 #include "XsdParser.h"
+#include <cstdlib>
 #include <iostream>
+#include <ranges>
 
 int main(int argc, const char* argv[]) {
+    // Параметры генерации задаются ключами вида --имя
+    Xsd::Options options;
+    bool layoutReport = false;
+    std::string samplePath;              // --sample=файл: синтетический экземпляр схемы
+    uint64_t sampleSize = 1 << 20, seed = 0;
+    for(int i = 1; i < argc; ++i) {
+        if(std::string_view{argv[i]} == "--lazy-collections") options.lazyCollections = true;
+        if(std::string_view{argv[i]} == "--parallel-collections") options.parallelCollections = true;
+        if(std::string_view{argv[i]} == "--descriptors") options.descriptors = true;
+        if(std::string_view{argv[i]} == "--lean-headers") options.leanHeaders = true;
+        if(std::string_view{argv[i]} == "--modules") options.modules = true;
+        if(std::string_view{argv[i]} == "--module-partitions") options.modules = options.modulePartitions = true;
+        if(std::string_view{argv[i]}.starts_with("--inline-strings=")) options.inlineStrings = std::atoi(argv[i] + 17);
+        if(std::string_view{argv[i]} == "--reorder-members") options.reorderMembers = true;
+        if(std::string_view{argv[i]} == "--bench") options.bench = true;
+        if(std::string_view{argv[i]} == "--streaming") options.streaming = true;
+        if(std::string_view{argv[i]} == "--batch") options.batch = true;
+        if(std::string_view{argv[i]} == "--structural-hash") options.structuralHash = true;
+        if(std::string_view{argv[i]} == "--intern") options.structuralHash = options.intern = true;
+        if(std::string_view{argv[i]}.starts_with("--pool-strings=")) {
+            // Имена полей через запятую
+            for(auto name: std::string_view{argv[i] + 15} | std::views::split(','))
+                options.pooledStrings.emplace_back(std::string_view{name});
+        }
+        if(std::string_view{argv[i]}.starts_with("--pool-strings-from=")) options.pooledStringsSample = argv[i] + 20;
+        if(std::string_view{argv[i]} == "--expected") options.expected = true;
+        if(std::string_view{argv[i]} == "--comparisons") options.structuralHash = options.comparisons = true;
+        if(std::string_view{argv[i]} == "--embed") options.embed = true;
+        if(std::string_view{argv[i]} == "--memory-report") options.memoryReport = true;
+        if(std::string_view{argv[i]} == "--trace") options.trace = true;
+        if(std::string_view{argv[i]} == "--layout-report") layoutReport = true;
+        if(std::string_view{argv[i]}.starts_with("--sample=")) samplePath = argv[i] + 9;
+        if(std::string_view{argv[i]}.starts_with("--sample-size=")) sampleSize = std::strtoull(argv[i] + 14, nullptr, 10);
+        if(std::string_view{argv[i]}.starts_with("--seed=")) seed = std::strtoull(argv[i] + 7, nullptr, 10);
+    }
 
     const char* argv_[]{
         argv[0],
@@ -24,6 +61,7 @@ int main(int argc, const char* argv[]) {
 
     try {
         Xsd::Parser parser;
+        parser.setOptions(options);
 
         // Парсим XSD схему
         if(!parser.parse(xsdFile)) {
@@ -33,6 +71,11 @@ int main(int argc, const char* argv[]) {
 
         // Выводим информацию о схеме
         parser.printSummary();
+        if(layoutReport) parser.printLayoutReport();
+        if(!samplePath.empty() && !parser.generateInstance(samplePath, sampleSize, seed)) {
+            std::cerr << "Ошибка при создании экземпляра" << std::endl;
+            return 1;
+        }
 
         // Генерируем C++ код
         if(!parser.generateCppCode(outputDir, "Generated")) {
@@ -45,7 +88,53 @@ int main(int argc, const char* argv[]) {
         std::cout << "  - " << outputDir << "/Enums.h" << std::endl;
         std::cout << "  - " << outputDir << "/Enums.cpp" << std::endl;
         std::cout << "  - " << outputDir << "/Types.h" << std::endl;
-        std::cout << "  - " << outputDir << "/Types.cpp" << std::endl;
+        if(options.leanHeaders) {
+            std::cout << "  - " << outputDir << "/Enums_io.h" << std::endl;
+            std::cout << "  - " << outputDir << "/Types_fwd.h" << std::endl;
+        }
+        if(options.descriptors)
+            std::cout << "  - " << outputDir << "/Descriptors.h" << std::endl;
+        std::cout << "  - " << outputDir << "/Writer.h" << std::endl;
+        std::cout << "  - " << outputDir << "/Writer.cpp" << std::endl;
+        std::cout << "  - " << outputDir << "/Reader.h" << std::endl;
+        std::cout << "  - " << outputDir << "/Reader.cpp" << std::endl;
+        std::cout << "  - " << outputDir << "/Binary.h" << std::endl;
+        std::cout << "  - " << outputDir << "/Binary.cpp" << std::endl;
+        std::cout << "  - " << outputDir << "/Validate.h" << std::endl;
+        std::cout << "  - " << outputDir << "/Validate.cpp" << std::endl;
+        if(options.modules) {
+            std::cout << "  - " << outputDir << "/Generated.cppm" << std::endl;
+            if(options.modulePartitions)
+                std::cout << "  - " << outputDir << "/Generated-{Types,Reader,Writer,Binary,Validate}.cppm" << std::endl;
+        }
+        if(options.streaming) {
+            std::cout << "  - " << outputDir << "/Stream.h" << std::endl;
+            std::cout << "  - " << outputDir << "/Stream.cpp" << std::endl;
+        }
+        if(options.structuralHash)
+            std::cout << "  - " << outputDir << "/Hash.cpp" << std::endl;
+        if(options.batch) {
+            std::cout << "  - " << outputDir << "/Batch.h" << std::endl;
+            std::cout << "  - " << outputDir << "/Batch.cpp" << std::endl;
+        }
+        if(options.expected) {
+            std::cout << "  - " << outputDir << "/Expected.h" << std::endl;
+            std::cout << "  - " << outputDir << "/Expected.cpp" << std::endl;
+        }
+        if(options.bench)
+            std::cout << "  - " << outputDir << "/Bench.cpp" << std::endl;
+        if(options.embed) {
+            std::cout << "  - " << outputDir << "/Literal.h" << std::endl;
+            std::cout << "  - " << outputDir << "/Embed.cpp" << std::endl;
+        }
+        if(options.memoryReport) {
+            std::cout << "  - " << outputDir << "/Memory.h" << std::endl;
+            std::cout << "  - " << outputDir << "/Memory.cpp" << std::endl;
+        }
+        if(options.trace) {
+            std::cout << "  - " << outputDir << "/Trace.h" << std::endl;
+            std::cout << "  - " << outputDir << "/Trace.cpp" << std::endl;
+        }
         std::cout << "  - " << outputDir << "/CMakeLists.txt" << std::endl;
 
     } catch(const std::exception& e) {
@@ -0,0 +1,48 @@
+// Число выделений памяти при разборе схемы: построение IR перемещает поля и типы
+// в контейнеры, а не копирует их. Тест не даёт числу выделений вырасти незаметно.
+#include "XsdParser.h"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(void* pointer = std::malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+int main(int argc, char* argv[]) {
+    if(argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " schema.xsd max-allocations" << std::endl;
+        return 2;
+    }
+    const std::size_t limit = std::strtoull(argv[2], nullptr, 10);
+
+    // Выделения tinyxml2 на загрузку документа не зависят от генератора и вычитаются
+    std::size_t before = allocations.load();
+    {
+        tinyxml2::XMLDocument doc;
+        doc.LoadFile(argv[1]);
+    }
+    const std::size_t document = allocations.load() - before;
+
+    Xsd::Parser parser;
+    before = allocations.load();
+    if(!parser.parse(argv[1])) return 1;
+    const std::size_t total = allocations.load() - before;
+    const std::size_t schema = total - document;
+
+    std::cout << "operator new: " << total << " total, " << document << " document, "
+              << schema << " schema IR (limit " << limit << ")" << std::endl;
+    return schema <= limit ? 0 : 1;
+}